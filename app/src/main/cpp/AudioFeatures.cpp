@@ -0,0 +1,116 @@
+#include "AudioFeatures.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+constexpr float kPreEmphasis = 0.97f;
+constexpr float kLogFloor = 1e-10f;
+
+static float hzToMel(float hz) { return 2595.0f * std::log10(1.0f + hz / 700.0f); }
+
+static float melToHz(float mel) { return 700.0f * (std::pow(10.0f, mel / 2595.0f) - 1.0f); }
+
+FeatureExtractor::FeatureExtractor(const FeatureConfig &config) :
+    config_(config),
+    fft_(config.fftSize),
+    pendingCount_(0),
+    lastSample_(0.0f) {
+    window_.resize(config_.frameLength);
+    for (int i = 0; i < config_.frameLength; i++) {
+        window_[i] = 0.54f - 0.46f * std::cos(2.0f * float(M_PI) * i / (config_.frameLength - 1));
+    }
+
+    // Triangular filters evenly spaced on the mel scale
+    const int bins = config_.fftSize / 2 + 1;
+    const float melLow = hzToMel(config_.lowHz);
+    const float melHigh = hzToMel(config_.highHz);
+    std::vector<float> edges(config_.melBands + 2);
+    for (int i = 0; i < (int) edges.size(); i++) {
+        float hz = melToHz(melLow + (melHigh - melLow) * i / (config_.melBands + 1));
+        edges[i] = hz * config_.fftSize / config_.sampleRate;
+    }
+    melStart_.resize(config_.melBands);
+    melOffset_.resize(config_.melBands + 1);
+    for (int band = 0; band < config_.melBands; band++) {
+        float left = edges[band], center = edges[band + 1], right = edges[band + 2];
+        int first = std::max(0, int(std::ceil(left)));
+        int last = std::min(bins - 1, int(std::floor(right)));
+        melStart_[band] = first;
+        melOffset_[band] = (int) melWeights_.size();
+        for (int bin = first; bin <= last; bin++) {
+            float w = bin <= center ? (bin - left) / (center - left) : (right - bin) / (right - center);
+            melWeights_.push_back(std::max(0.0f, w));
+        }
+    }
+    melOffset_[config_.melBands] = (int) melWeights_.size();
+
+    dct_.resize(config_.mfccCount * config_.melBands);
+    const float scale = std::sqrt(2.0f / config_.melBands);
+    for (int k = 0; k < config_.mfccCount; k++) {
+        for (int n = 0; n < config_.melBands; n++) {
+            dct_[k * config_.melBands + n] =
+                    scale * std::cos(float(M_PI) * k * (n + 0.5f) / config_.melBands);
+        }
+    }
+
+    pending_.resize(config_.frameLength);
+    frame_.resize(config_.fftSize);
+    power_.resize(bins);
+    logMel_.resize(config_.melBands);
+}
+
+void FeatureExtractor::reset() {
+    pendingCount_ = 0;
+    lastSample_ = 0.0f;
+}
+
+int FeatureExtractor::process(const int16_t *pcm, int count, std::vector<float> &outFeatures) {
+    int frames = 0;
+    for (int i = 0; i < count; i++) {
+        float sample = pcm[i] * (1.0f / 32768.0f);
+        pending_[pendingCount_++] = sample - kPreEmphasis * lastSample_;
+        lastSample_ = sample;
+
+        if (pendingCount_ == config_.frameLength) {
+            size_t base = outFeatures.size();
+            outFeatures.resize(base + config_.mfccCount);
+            computeFrame(pending_.data(), outFeatures.data() + base);
+            frames++;
+
+            // Keep the overlap for the next window
+            int keep = config_.frameLength - config_.hopLength;
+            std::memmove(pending_.data(), pending_.data() + config_.hopLength, keep * sizeof(float));
+            pendingCount_ = keep;
+        }
+    }
+    return frames;
+}
+
+void FeatureExtractor::computeFrame(const float *samples, float *outMfcc) {
+    for (int i = 0; i < config_.frameLength; i++) {
+        frame_[i] = samples[i] * window_[i];
+    }
+    std::fill(frame_.begin() + config_.frameLength, frame_.end(), 0.0f);
+    fft_.powerSpectrum(frame_.data(), power_.data());
+
+    for (int band = 0; band < config_.melBands; band++) {
+        const float *weights = melWeights_.data() + melOffset_[band];
+        const float *power = power_.data() + melStart_[band];
+        int width = melOffset_[band + 1] - melOffset_[band];
+        float energy = 0.0f;
+        for (int i = 0; i < width; i++) {
+            energy += weights[i] * power[i];
+        }
+        logMel_[band] = std::log(std::max(energy, kLogFloor));
+    }
+
+    for (int k = 0; k < config_.mfccCount; k++) {
+        const float *row = dct_.data() + k * config_.melBands;
+        float sum = 0.0f;
+        for (int n = 0; n < config_.melBands; n++) {
+            sum += row[n] * logMel_[n];
+        }
+        outMfcc[k] = sum;
+    }
+}
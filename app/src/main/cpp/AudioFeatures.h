@@ -0,0 +1,68 @@
+#ifndef MAGEVOICE_AUDIOFEATURES_H
+#define MAGEVOICE_AUDIOFEATURES_H
+
+#include <cstdint>
+#include <vector>
+
+#include "Fft.h"
+
+// Front end parameters. The defaults give 25 ms windows every 10 ms at 16 kHz.
+struct FeatureConfig {
+    int sampleRate = 16000;
+    int frameLength = 400;
+    int hopLength = 160;
+    int fftSize = 512;
+    int melBands = 40;
+    int mfccCount = 13;
+    float lowHz = 60.0f;
+    float highHz = 7600.0f;
+};
+
+/*!
+ * Streaming log-mel / MFCC extractor.
+ *
+ * PCM can be pushed in chunks of any size; one feature vector of mfccCount values is produced per
+ * hop once a full window has been buffered. Coefficient 0 follows the overall frame loudness.
+ */
+class FeatureExtractor {
+public:
+    explicit FeatureExtractor(const FeatureConfig &config = FeatureConfig());
+
+    /*!
+     * Consumes 16-bit PCM and appends the MFCC vectors of every completed frame to outFeatures.
+     * @return the number of frames appended
+     */
+    int process(const int16_t *pcm, int count, std::vector<float> &outFeatures);
+
+    // Drops buffered samples so the next call starts a fresh stream
+    void reset();
+
+    inline const FeatureConfig &getConfig() const { return config_; }
+
+    // Log-mel energies of the last computed frame, melBands values
+    inline const std::vector<float> &getLastLogMel() const { return logMel_; }
+
+private:
+    void computeFrame(const float *samples, float *outMfcc);
+
+    FeatureConfig config_;
+    Fft fft_;
+
+    std::vector<float> window_;
+    // Sparse triangular filters: first FFT bin and weights of each band
+    std::vector<int> melStart_;
+    std::vector<int> melOffset_;
+    std::vector<float> melWeights_;
+    // mfccCount x melBands DCT-II matrix
+    std::vector<float> dct_;
+
+    std::vector<float> pending_;
+    int pendingCount_;
+    float lastSample_;
+
+    std::vector<float> frame_;
+    std::vector<float> power_;
+    std::vector<float> logMel_;
+};
+
+#endif //MAGEVOICE_AUDIOFEATURES_H
@@ -0,0 +1,66 @@
+#include "Camera.h"
+
+#include <algorithm>
+#include <cmath>
+
+Camera::Camera(float halfHeight, float smoothingSeconds)
+        : halfHeight_(halfHeight), smoothingSeconds_(smoothingSeconds) {}
+
+void Camera::setViewport(int width, int height) {
+    const float aspect = width > 0 && height > 0 ? float(width) / float(height) : 1.0f;
+    if (aspect == aspect_) return;
+    aspect_ = aspect;
+    revision_++;
+    moveTo(centerX_, centerY_);
+}
+
+void Camera::setWorldBounds(const ViewRect &bounds) {
+    bounds_ = bounds;
+    bounded_ = true;
+    moveTo(centerX_, centerY_);
+}
+
+void Camera::follow(float x, float y, float dt) {
+    clampCenter(x, y);
+    const float dx = x - centerX_, dy = y - centerY_;
+    if (smoothingSeconds_ > 0.0f && dx * dx + dy * dy > kSettleDistance * kSettleDistance) {
+        const float blend = 1.0f - std::exp(-std::max(dt, 0.0f) / smoothingSeconds_);
+        x = centerX_ + dx * blend;
+        y = centerY_ + dy * blend;
+    }
+    moveTo(x, y);
+}
+
+void Camera::snapTo(float x, float y) { moveTo(x, y); }
+
+void Camera::moveTo(float x, float y) {
+    clampCenter(x, y);
+    if (x == centerX_ && y == centerY_) return;
+    centerX_ = x;
+    centerY_ = y;
+    revision_++;
+}
+
+void Camera::clampCenter(float &x, float &y) const {
+    if (!bounded_) return;
+    const float halfWidth = getHalfWidth();
+    x = bounds_.right - bounds_.left <= 2.0f * halfWidth
+        ? 0.5f * (bounds_.left + bounds_.right)
+        : std::clamp(x, bounds_.left + halfWidth, bounds_.right - halfWidth);
+    y = bounds_.top - bounds_.bottom <= 2.0f * halfHeight_
+        ? 0.5f * (bounds_.bottom + bounds_.top)
+        : std::clamp(y, bounds_.bottom + halfHeight_, bounds_.top - halfHeight_);
+}
+
+int Camera::cull(const float *x, const float *y, int count, float halfSize, uint32_t *outIndices) const {
+    const ViewRect view = getVisibleRect();
+    const float left = view.left - halfSize, right = view.right + halfSize;
+    const float bottom = view.bottom - halfSize, top = view.top + halfSize;
+    int visible = 0;
+    for (int i = 0; i < count; i++) {
+        // Always written, only kept (by advancing) when inside
+        outIndices[visible] = uint32_t(i);
+        visible += int((x[i] >= left) & (x[i] <= right) & (y[i] >= bottom) & (y[i] <= top));
+    }
+    return visible;
+}
@@ -0,0 +1,93 @@
+#ifndef MAGEVOICE_CAMERA_H
+#define MAGEVOICE_CAMERA_H
+
+#include <cstdint>
+
+// Axis aligned rectangle in world units, +y up
+struct ViewRect {
+    float left;
+    float bottom;
+    float right;
+    float top;
+};
+
+/*!
+ * Orthographic 2D camera that follows a target over a world larger than the screen.
+ *
+ * The view has a fixed half height in world units and the viewport's aspect ratio. follow()
+ * eases the centre toward the target with frame rate independent exponential smoothing and
+ * keeps the view inside the world bounds (centred on an axis where the world is smaller than
+ * the view). Any change of the centre or the viewport bumps getRevision(), so the renderer
+ * only uploads its matrices on frames where they changed; once the centre is within
+ * kSettleDistance of the target it snaps to it, so a camera at rest stops changing.
+ */
+class Camera {
+public:
+    static constexpr float kSettleDistance = 1e-3f;
+
+    /*!
+     * @param halfHeight half of the visible height in world units
+     * @param smoothingSeconds time constant of the follow; 0 follows rigidly
+     */
+    explicit Camera(float halfHeight = 10.0f, float smoothingSeconds = 0.15f);
+
+    // Viewport in pixels, for the aspect ratio
+    void setViewport(int width, int height);
+
+    void setWorldBounds(const ViewRect &bounds);
+
+    // Moves the centre toward (x, y) after dt seconds
+    void follow(float x, float y, float dt);
+
+    // Centres on (x, y) at once, e.g. on spawn or teleport
+    void snapTo(float x, float y);
+
+    inline float getCenterX() const { return centerX_; }
+
+    inline float getCenterY() const { return centerY_; }
+
+    inline float getHalfWidth() const { return halfHeight_ * aspect_; }
+
+    inline float getHalfHeight() const { return halfHeight_; }
+
+    inline float getAspect() const { return aspect_; }
+
+    // Changes whenever the view or projection does
+    inline uint32_t getRevision() const { return revision_; }
+
+    inline ViewRect getVisibleRect() const {
+        const float halfWidth = getHalfWidth();
+        return {centerX_ - halfWidth, centerY_ - halfHeight_, centerX_ + halfWidth, centerY_ + halfHeight_};
+    }
+
+    // True if a square of the given half size at (x, y) overlaps the view
+    inline bool isVisible(float x, float y, float halfSize) const {
+        return x + halfSize >= centerX_ - getHalfWidth() && x - halfSize <= centerX_ + getHalfWidth() &&
+               y + halfSize >= centerY_ - halfHeight_ && y - halfSize <= centerY_ + halfHeight_;
+    }
+
+    /*!
+     * Writes the index of every point whose square of the given half size overlaps the view to
+     * outIndices, in input order, and returns how many there are. Without branches on the
+     * test, so it does not pay for mispredictions when visibility is random.
+     * @param outIndices room for count indices
+     */
+    int cull(const float *x, const float *y, int count, float halfSize, uint32_t *outIndices) const;
+
+private:
+    // Nearest centre that keeps the view inside the bounds
+    void clampCenter(float &x, float &y) const;
+
+    void moveTo(float x, float y);
+
+    float halfHeight_;
+    float smoothingSeconds_;
+    float aspect_ = 1.0f;
+    float centerX_ = 0.0f;
+    float centerY_ = 0.0f;
+    bool bounded_ = false;
+    ViewRect bounds_{};
+    uint32_t revision_ = 1;
+};
+
+#endif //MAGEVOICE_CAMERA_H
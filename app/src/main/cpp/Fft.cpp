@@ -0,0 +1,109 @@
+#include "Fft.h"
+
+#include <cassert>
+#include <cmath>
+#include <utility>
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+Fft::Fft(int size) : size_(size) {
+    assert(size >= 2 && (size & (size - 1)) == 0);
+
+    int bits = 0;
+    while ((1 << bits) < size) bits++;
+    bitReverse_.resize(size);
+    for (int i = 0; i < size; i++) {
+        int r = 0;
+        for (int b = 0; b < bits; b++) {
+            if (i & (1 << b)) r |= 1 << (bits - 1 - b);
+        }
+        bitReverse_[i] = r;
+    }
+
+    twiddleRe_.resize(size - 1);
+    twiddleIm_.resize(size - 1);
+    for (int half = 1; half < size; half *= 2) {
+        for (int j = 0; j < half; j++) {
+            double angle = -M_PI * j / half;
+            twiddleRe_[half - 1 + j] = float(std::cos(angle));
+            twiddleIm_[half - 1 + j] = float(std::sin(angle));
+        }
+    }
+
+    scratchRe_.resize(size);
+    scratchIm_.resize(size);
+}
+
+// One radix-2 stage over a block: a' = a + w*b, b' = a - w*b
+static inline void butterflies(float *aRe, float *aIm, float *bRe, float *bIm,
+                               const float *wRe, const float *wIm, int count) {
+    int j = 0;
+#if defined(__ARM_NEON)
+    for (; j + 4 <= count; j += 4) {
+        float32x4_t ar = vld1q_f32(aRe + j), ai = vld1q_f32(aIm + j);
+        float32x4_t br = vld1q_f32(bRe + j), bi = vld1q_f32(bIm + j);
+        float32x4_t wr = vld1q_f32(wRe + j), wi = vld1q_f32(wIm + j);
+        float32x4_t tr = vmlsq_f32(vmulq_f32(wr, br), wi, bi);
+        float32x4_t ti = vmlaq_f32(vmulq_f32(wr, bi), wi, br);
+        vst1q_f32(aRe + j, vaddq_f32(ar, tr));
+        vst1q_f32(aIm + j, vaddq_f32(ai, ti));
+        vst1q_f32(bRe + j, vsubq_f32(ar, tr));
+        vst1q_f32(bIm + j, vsubq_f32(ai, ti));
+    }
+#elif defined(__SSE2__)
+    for (; j + 4 <= count; j += 4) {
+        __m128 ar = _mm_loadu_ps(aRe + j), ai = _mm_loadu_ps(aIm + j);
+        __m128 br = _mm_loadu_ps(bRe + j), bi = _mm_loadu_ps(bIm + j);
+        __m128 wr = _mm_loadu_ps(wRe + j), wi = _mm_loadu_ps(wIm + j);
+        __m128 tr = _mm_sub_ps(_mm_mul_ps(wr, br), _mm_mul_ps(wi, bi));
+        __m128 ti = _mm_add_ps(_mm_mul_ps(wr, bi), _mm_mul_ps(wi, br));
+        _mm_storeu_ps(aRe + j, _mm_add_ps(ar, tr));
+        _mm_storeu_ps(aIm + j, _mm_add_ps(ai, ti));
+        _mm_storeu_ps(bRe + j, _mm_sub_ps(ar, tr));
+        _mm_storeu_ps(bIm + j, _mm_sub_ps(ai, ti));
+    }
+#endif
+    for (; j < count; j++) {
+        float tr = wRe[j] * bRe[j] - wIm[j] * bIm[j];
+        float ti = wRe[j] * bIm[j] + wIm[j] * bRe[j];
+        bRe[j] = aRe[j] - tr;
+        bIm[j] = aIm[j] - ti;
+        aRe[j] += tr;
+        aIm[j] += ti;
+    }
+}
+
+void Fft::forward(float *re, float *im) const {
+    for (int i = 0; i < size_; i++) {
+        int r = bitReverse_[i];
+        if (r > i) {
+            std::swap(re[i], re[r]);
+            std::swap(im[i], im[r]);
+        }
+    }
+
+    for (int half = 1; half < size_; half *= 2) {
+        const float *wRe = twiddleRe_.data() + half - 1;
+        const float *wIm = twiddleIm_.data() + half - 1;
+        for (int start = 0; start < size_; start += 2 * half) {
+            butterflies(re + start, im + start, re + start + half, im + start + half, wRe, wIm, half);
+        }
+    }
+}
+
+void Fft::powerSpectrum(const float *input, float *outPower) {
+    float *re = scratchRe_.data();
+    float *im = scratchIm_.data();
+    for (int i = 0; i < size_; i++) {
+        re[i] = input[i];
+        im[i] = 0.0f;
+    }
+    forward(re, im);
+    for (int k = 0; k <= size_ / 2; k++) {
+        outPower[k] = re[k] * re[k] + im[k] * im[k];
+    }
+}
@@ -0,0 +1,45 @@
+#ifndef MAGEVOICE_FFT_H
+#define MAGEVOICE_FFT_H
+
+#include <vector>
+
+/*!
+ * Iterative radix-2 complex FFT on split real/imaginary arrays.
+ *
+ * Twiddles are stored contiguously per stage so the butterfly loop runs four lanes at a time
+ * with NEON or SSE when available.
+ */
+class Fft {
+public:
+    /*!
+     * @param size transform length, must be a power of two
+     */
+    explicit Fft(int size);
+
+    /*!
+     * In-place forward transform.
+     * @param re real parts, size() elements
+     * @param im imaginary parts, size() elements
+     */
+    void forward(float *re, float *im) const;
+
+    /*!
+     * Forward transform of real input, writing |X[k]|^2 for k in [0, size() / 2].
+     * @param input size() real samples, left untouched
+     * @param outPower size() / 2 + 1 power values
+     */
+    void powerSpectrum(const float *input, float *outPower);
+
+    inline int size() const { return size_; }
+
+private:
+    int size_;
+    std::vector<int> bitReverse_;
+    // Stage with half-length h keeps its h twiddles at offset h - 1
+    std::vector<float> twiddleRe_;
+    std::vector<float> twiddleIm_;
+    std::vector<float> scratchRe_;
+    std::vector<float> scratchIm_;
+};
+
+#endif //MAGEVOICE_FFT_H
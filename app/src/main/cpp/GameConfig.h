@@ -0,0 +1,25 @@
+#ifndef MAGEVOICE_GAMECONFIG_H
+#define MAGEVOICE_GAMECONFIG_H
+
+#include <cstdint>
+
+// Native counterparts of com.game.voicespells.utils.GameConfig
+
+constexpr int kTickRate = 60; // Simulation ticks per second
+constexpr float kTickSeconds = 1.0f / kTickRate;
+constexpr float kMapSize = 50.0f; // Map is a square centered on the origin
+
+// Native arena tilemap (Tilemap::makeArena), shared by the client renderer and the server so both
+// agree on where players can stand. Several screens wide, unlike the Kotlin MAP_SIZE.
+constexpr int kArenaTiles = 128;
+constexpr float kArenaRockDensity = 0.08f;
+constexpr uint64_t kArenaSeed = 1;
+constexpr float kPlayerSpeed = 5.0f; // Units per second
+constexpr int kMaxHp = 100;
+constexpr int kMaxMana = 100;
+constexpr float kManaRegen = 10.0f; // Mana per second
+constexpr float kRespawnSeconds = 10.0f;
+
+inline int secondsToTicks(float seconds) { return int(seconds * kTickRate + 0.5f); }
+
+#endif //MAGEVOICE_GAMECONFIG_H
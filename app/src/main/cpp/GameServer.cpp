@@ -0,0 +1,250 @@
+#include "GameServer.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "Physics.h"
+#include "WireFormat.h"
+
+constexpr int kSocketBufferBytes = 1 << 20;
+// Entity ids are 16 bit on the wire
+constexpr int kMaxSessions = 65536;
+
+// Default table with cooldowns and durations converted from kTickRate ticks to the server's
+static SpellTable scaledSpellTable(int tickRate) {
+    SpellTable table = SpellTable::defaults();
+    const float scale = float(tickRate) / float(kTickRate);
+    for (int i = 0; i < kSpellTypeCount; i++) {
+        SpellDefinition &def = table.get(static_cast<SpellType>(i));
+        def.cooldownTicks = uint16_t(std::lround(def.cooldownTicks * scale));
+        def.effectTicks = uint16_t(std::lround(def.effectTicks * scale));
+    }
+    return table;
+}
+
+GameServer::GameServer(const ServerConfig &config)
+        : config_(config),
+          tilemap_(Tilemap::makeArena(config.arenaTiles, config.arenaTiles, config.arenaRockDensity, config.arenaSeed)),
+          spells_(scaledSpellTable(config.tickRate)),
+          interest_(config.interest),
+          dt_(1.0f / float(config.tickRate)),
+          timeoutTicks_(uint32_t(config.clientTimeoutSeconds * config.tickRate)),
+          respawnTicks_(uint32_t(kRespawnSeconds * config.tickRate)),
+          maxRewindTicks_(uint32_t(std::lround(std::max(0.0f, config.maxRewindSeconds) * config.tickRate))),
+          manaPerTick_(kManaRegen / float(config.tickRate)),
+          receiveBuffer_(WireFormat::kMaxDatagramBytes) {
+    if (maxRewindTicks_ > 0) {
+        // Casts resolve before their tick is recorded, so the window needs exactly that many past ticks
+        history_.reset(int(maxRewindTicks_), std::max(spells_.getTable().getMaxRadius(), 1.0f));
+        spells_.setHistory(&history_, maxRewindTicks_);
+    }
+}
+
+bool GameServer::open(uint16_t port) {
+    return socket_.open(port, kSocketBufferBytes);
+}
+
+void GameServer::receive() {
+    NetAddress from;
+    int size;
+    // Runs until the queue is empty; an empty datagram from any peer must not end the drain early
+    while ((size = socket_.receiveFrom(receiveBuffer_.data(), receiveBuffer_.size(), from)) >= 0) {
+        traffic_.packetsIn++;
+        if (size == 0) continue;
+        traffic_.bytesIn += size;
+        const uint8_t *data = receiveBuffer_.data();
+        switch (static_cast<NetMessageType>(NetMessage::type(data, size))) {
+            case NetMessageType::Join:
+                handleJoin(from);
+                break;
+            case NetMessageType::Leave:
+                handleLeave(from);
+                break;
+            case NetMessageType::Input:
+                handleInput(from, data, size);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+void GameServer::handleJoin(const NetAddress &from) {
+    auto found = sessionByAddress_.find(from.key());
+    int index;
+    if (found != sessionByAddress_.end()) {
+        // Retransmitted join, the welcome was probably lost
+        index = found->second;
+    } else {
+        // Reuse the slot (and entity) of a client that left
+        index = -1;
+        for (int i = 0; i < (int) sessions_.size(); i++) {
+            if (!sessions_[i].active) {
+                index = i;
+                break;
+            }
+        }
+        if (index < 0) {
+            if ((int) sessions_.size() >= kMaxSessions) return;
+            Session session;
+            session.entity = world_.add(0.0f, 0.0f);
+            session.interestClient = interest_.addClient(session.entity);
+            sessions_.push_back(session);
+            index = (int) sessions_.size() - 1;
+        }
+
+        Session &session = sessions_[index];
+        session.address = from;
+        session.active = true;
+        session.input = ClientInput();
+        session.castPending = false;
+        session.diedTick = 0;
+        interest_.setViewer(session.interestClient, session.entity);
+        sessionByAddress_[from.key()] = index;
+        activeClients_++;
+
+        // Spawn on a spiral so joining players do not stack
+        const EntityId e = session.entity;
+        findSpawn(index, world_.posX[e], world_.posY[e]);
+        world_.velX[e] = world_.velY[e] = 0.0f;
+        world_.hp[e] = kMaxHp;
+        world_.mana[e] = kMaxMana;
+        world_.alive[e] = 1;
+        world_.shieldUntil[e] = world_.slowUntil[e] = 0;
+    }
+
+    Session &session = sessions_[index];
+    session.lastHeardTick = world_.tick;
+    NetMessage::writeWelcome(message_, session.entity, world_.tick);
+    send(from, message_);
+}
+
+void GameServer::handleLeave(const NetAddress &from) {
+    auto found = sessionByAddress_.find(from.key());
+    if (found == sessionByAddress_.end()) return;
+    Session &session = sessions_[found->second];
+    session.active = false;
+    world_.alive[session.entity] = 0;
+    // No viewer: the interest manager skips the client
+    interest_.setViewer(session.interestClient, EntityId(UINT32_MAX));
+    sessionByAddress_.erase(found);
+    activeClients_--;
+}
+
+void GameServer::handleInput(const NetAddress &from, const uint8_t *data, size_t size) {
+    auto found = sessionByAddress_.find(from.key());
+    ClientInput input;
+    if (found == sessionByAddress_.end() || !NetMessage::readInput(data, size, input)) return;
+    Session &session = sessions_[found->second];
+    session.lastHeardTick = world_.tick;
+    // Datagrams can arrive out of order; only the newest input counts
+    if (input.sequence <= session.input.sequence && session.input.sequence != 0) return;
+    session.input = input;
+    if (input.spell != SpellType::Count) session.castPending = true;
+}
+
+void GameServer::findSpawn(int n, float &outX, float &outY) const {
+    const ObstacleGrid &obstacles = tilemap_.getObstacles();
+    const float maxRadius = 0.5f * float(config_.arenaTiles);
+    // Walk the spiral outward from the n-th point until a spot clear of rocks turns up
+    for (int k = n; k < n + 4096; k++) {
+        const float angle = 2.39996f * float(k);
+        const float radius = std::min(maxRadius, 1.5f * std::sqrt(float(k)));
+        outX = radius * std::cos(angle);
+        outY = radius * std::sin(angle);
+        if (!obstacles.overlaps(outX, outY, Physics::kPlayerRadius)) return;
+    }
+    // makeArena keeps the centre clear
+    outX = outY = 0.0f;
+}
+
+void GameServer::send(const NetAddress &to, const std::vector<uint8_t> &message) {
+    if (socket_.sendTo(to, message.data(), message.size())) {
+        traffic_.bytesOut += message.size();
+        traffic_.packetsOut++;
+    }
+}
+
+void GameServer::updateLife() {
+    manaCarry_ += manaPerTick_;
+    const int mana = int(manaCarry_);
+    manaCarry_ -= float(mana);
+
+    for (Session &session : sessions_) {
+        if (!session.active) continue;
+        const EntityId e = session.entity;
+        if (world_.tick - session.lastHeardTick > timeoutTicks_) {
+            handleLeave(session.address);
+            continue;
+        }
+        if (world_.alive[e]) {
+            world_.mana[e] = std::min(kMaxMana, world_.mana[e] + mana);
+        } else if (session.diedTick == 0) {
+            session.diedTick = world_.tick;
+        } else if (world_.tick - session.diedTick >= respawnTicks_) {
+            world_.alive[e] = 1;
+            world_.hp[e] = kMaxHp;
+            world_.mana[e] = kMaxMana;
+            world_.posX[e] = world_.posY[e] = 0.0f;
+            session.diedTick = 0;
+        }
+    }
+}
+
+void GameServer::simulate() {
+    const int entities = world_.size();
+
+    // Newest input of every client; dead and departed players stand still
+    casts_.clear();
+    for (Session &session : sessions_) {
+        const EntityId e = session.entity;
+        const bool controllable = session.active && world_.alive[e];
+        world_.velX[e] = controllable ? session.input.moveX : 0.0f;
+        world_.velY[e] = controllable ? session.input.moveY : 0.0f;
+        if (controllable && session.castPending) {
+            CastRequest cast{e, session.input.spell, session.input.targetX, session.input.targetY,
+                             session.input.viewTick};
+            // The target comes from the client: a modified one could otherwise land spells anywhere
+            spells_.clampToRange(world_, cast);
+            spells_.queueCast(cast);
+            casts_.push_back(cast);
+        }
+        session.castPending = false;
+    }
+
+    const ObstacleGrid &obstacles = tilemap_.getObstacles();
+    Physics::move(world_, 0, entities, dt_, obstacles);
+    nextX_.resize(entities);
+    nextY_.resize(entities);
+    grid_.build(world_.posX.data(), world_.posY.data(), entities, 2.0f * Physics::kPlayerRadius);
+    Physics::separate(world_, grid_, 0, entities, nextX_.data(), nextY_.data());
+    // Pushes slide along rocks and the map edge like movement does, never into them
+    for (int e = 0; e < entities; e++) {
+        obstacles.slide(world_.posX[e], world_.posY[e], nextX_[e] - world_.posX[e], nextY_[e] - world_.posY[e],
+                        Physics::kPlayerRadius);
+    }
+
+    // Results come back in queue order, so they line up with casts_
+    spells_.resolve(world_, obstacles, &results_);
+    events_.clear();
+    for (size_t i = 0; i < results_.size(); i++) {
+        if (results_[i].status != CastStatus::Cast) continue;
+        events_.push_back({casts_[i].caster, casts_[i].spell, casts_[i].targetX, casts_[i].targetY, world_.tick});
+    }
+}
+
+void GameServer::tick() {
+    updateLife();
+    simulate();
+
+    // Positions as the clients will see them in this tick's state
+    if (maxRewindTicks_ > 0) history_.record(world_);
+
+    interest_.update(world_, events_);
+    for (const Session &session : sessions_) {
+        if (!session.active) continue;
+        NetMessage::writeState(message_, interest_.getPacket(session.interestClient));
+        send(session.address, message_);
+    }
+    world_.tick++;
+}
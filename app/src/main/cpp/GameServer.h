@@ -0,0 +1,127 @@
+#ifndef MAGEVOICE_GAMESERVER_H
+#define MAGEVOICE_GAMESERVER_H
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "InterestManager.h"
+#include "NetMessage.h"
+#include "PositionHistory.h"
+#include "SpatialGrid.h"
+#include "SpellSystem.h"
+#include "Tilemap.h"
+#include "UdpSocket.h"
+#include "World.h"
+
+struct ServerConfig {
+    int tickRate = kTickRate;
+    // Arena tilemap (Tilemap::makeArena); the defaults are the level the client renders
+    int arenaTiles = kArenaTiles;
+    float arenaRockDensity = kArenaRockDensity;
+    uint64_t arenaSeed = kArenaSeed;
+    // Clients silent for this long are dropped
+    float clientTimeoutSeconds = 5.0f;
+    // Casts are hit tested against the world their caster saw, at most this far back; 0 disables
+    float maxRewindSeconds = 0.2f;
+    InterestConfig interest;
+};
+
+// Payload bytes, UDP/IP headers not included
+struct ServerTraffic {
+    uint64_t bytesIn = 0;
+    uint64_t bytesOut = 0;
+    uint64_t packetsIn = 0;
+    uint64_t packetsOut = 0;
+};
+
+/*!
+ * Authoritative simulation of one match over UDP, without any rendering or JNI.
+ *
+ * Clients join with a datagram, then stream their latest joystick and spell input. Each tick()
+ * applies the newest input of every client, moves and separates the players on the arena tilemap
+ * (sliding along its rocks, like the client does), resolves the casts
+ * in one SpellSystem batch and sends every client its area-of-interest filtered state. Casts are
+ * hit tested at the tick of the newest state their client had seen, from a PositionHistory
+ * recorded after every tick.
+ * Spell cooldowns and durations are scaled from kTickRate to the configured tick rate, so the
+ * game plays the same at any rate.
+ */
+class GameServer {
+public:
+    explicit GameServer(const ServerConfig &config = ServerConfig());
+
+    // @param port 0 for an ephemeral port
+    bool open(uint16_t port);
+
+    inline uint16_t getPort() const { return socket_.getLocalPort(); }
+
+    // Reads every pending datagram: joins, leaves and inputs
+    void receive();
+
+    // Advances the simulation by one tick and sends the state to every client
+    void tick();
+
+    inline int getClientCount() const { return activeClients_; }
+
+    inline const ServerTraffic &getTraffic() const { return traffic_; }
+
+    inline const World &getWorld() const { return world_; }
+
+    inline const ServerConfig &getConfig() const { return config_; }
+
+    inline const Tilemap &getTilemap() const { return tilemap_; }
+
+private:
+    struct Session {
+        NetAddress address;
+        EntityId entity = 0;
+        int interestClient = 0;
+        bool active = false;
+        uint32_t lastHeardTick = 0;
+        uint32_t diedTick = 0;
+        ClientInput input;
+        // Cast carried by the newest input, consumed by the next tick
+        bool castPending = false;
+    };
+
+    void handleJoin(const NetAddress &from);
+    void handleLeave(const NetAddress &from);
+    void handleInput(const NetAddress &from, const uint8_t *data, size_t size);
+    void send(const NetAddress &to, const std::vector<uint8_t> &message);
+    void updateLife();
+    // Free ground near the n-th point of a spiral around the centre
+    void findSpawn(int n, float &outX, float &outY) const;
+    void simulate();
+
+    ServerConfig config_;
+    Tilemap tilemap_;
+    UdpSocket socket_;
+    World world_;
+    SpellSystem spells_;
+    PositionHistory history_;
+    InterestManager interest_;
+    SpatialGrid grid_;
+
+    std::vector<Session> sessions_;
+    std::unordered_map<uint64_t, int> sessionByAddress_;
+    int activeClients_ = 0;
+
+    float dt_;
+    uint32_t timeoutTicks_;
+    uint32_t respawnTicks_;
+    uint32_t maxRewindTicks_;
+    float manaPerTick_;
+    float manaCarry_ = 0.0f;
+
+    std::vector<CastRequest> casts_;
+    std::vector<CastResult> results_;
+    std::vector<SpellEvent> events_;
+    std::vector<float> nextX_;
+    std::vector<float> nextY_;
+    std::vector<uint8_t> receiveBuffer_;
+    std::vector<uint8_t> message_;
+    ServerTraffic traffic_;
+};
+
+#endif //MAGEVOICE_GAMESERVER_H
@@ -0,0 +1,37 @@
+#include "GpuResourceCache.h"
+
+#include <utility>
+
+GpuResourceCache::TextureId GpuResourceCache::addTexture(int width, int height, std::vector<uint32_t> rgba,
+                                                         bool nearest) {
+    textures_.push_back({width, height, nearest, std::move(rgba)});
+    return TextureId(textures_.size() - 1);
+}
+
+void GpuResourceCache::restore() {
+    for (Texture &texture : textures_) {
+        if (texture.handle) continue;
+        const GLint filter = texture.nearest ? GL_NEAREST : GL_LINEAR;
+        glGenTextures(1, &texture.handle);
+        glBindTexture(GL_TEXTURE_2D, texture.handle);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, texture.width, texture.height, 0, GL_RGBA, GL_UNSIGNED_BYTE,
+                     texture.pixels.data());
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    }
+}
+
+void GpuResourceCache::release(bool contextLost) {
+    for (Texture &texture : textures_) {
+        if (texture.handle && !contextLost) glDeleteTextures(1, &texture.handle);
+        texture.handle = 0;
+    }
+}
+
+size_t GpuResourceCache::getCpuBytes() const {
+    size_t bytes = 0;
+    for (const Texture &texture : textures_) bytes += texture.pixels.size() * sizeof(uint32_t);
+    return bytes;
+}
@@ -0,0 +1,53 @@
+#ifndef MAGEVOICE_GPURESOURCECACHE_H
+#define MAGEVOICE_GPURESOURCECACHE_H
+
+#include <GLES3/gl3.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*!
+ * CPU copies of the textures the renderer creates procedurally, with their current GL handles.
+ *
+ * Textures are registered once, before or after a context exists. restore() (re)creates every
+ * GL texture from the copies, so losing the EGL context costs a re-upload instead of running
+ * the code that generated the pixels again.
+ */
+class GpuResourceCache {
+public:
+    using TextureId = int;
+
+    /*!
+     * Keeps the RGBA pixels; the GL texture is created by the next restore().
+     * @param nearest nearest filtering instead of linear
+     */
+    TextureId addTexture(int width, int height, std::vector<uint32_t> rgba, bool nearest = true);
+
+    // 0 until restore() ran on the current context
+    inline GLuint getTexture(TextureId id) const { return textures_[id].handle; }
+
+    // Creates the GL objects that are missing; the context must be current
+    void restore();
+
+    /*!
+     * Drops the GL objects.
+     * @param contextLost the context died and took the objects with it: forget the handles
+     *                    without calling GL
+     */
+    void release(bool contextLost);
+
+    size_t getCpuBytes() const;
+
+private:
+    struct Texture {
+        int width;
+        int height;
+        bool nearest;
+        std::vector<uint32_t> pixels;
+        GLuint handle = 0;
+    };
+
+    std::vector<Texture> textures_;
+};
+
+#endif //MAGEVOICE_GPURESOURCECACHE_H
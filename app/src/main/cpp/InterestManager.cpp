@@ -0,0 +1,104 @@
+#include "InterestManager.h"
+
+#include <algorithm>
+
+InterestManager::InterestManager(const InterestConfig &config) : config_(config) {}
+
+int InterestManager::addClient(EntityId viewer) {
+    Client client;
+    client.viewer = viewer;
+    clients_.push_back(std::move(client));
+    return (int) clients_.size() - 1;
+}
+
+void InterestManager::update(const World &world, const std::vector<SpellEvent> &events) {
+    const float outerRadius = config_.bands.back().radius;
+    grid_.build(world.posX.data(), world.posY.data(), world.size(), outerRadius * 0.5f);
+
+    const float eventRadiusSq = config_.eventRadius * config_.eventRadius;
+    for (Client &client : clients_) {
+        if ((int) client.priority.size() < world.size()) {
+            client.priority.resize(world.size(), 0.0f);
+            client.lastInRange.resize(world.size(), UINT32_MAX);
+        }
+        if (client.viewer >= (EntityId) world.size()) {
+            client.packet.clear();
+            continue;
+        }
+
+        const float vx = world.posX[client.viewer];
+        const float vy = world.posY[client.viewer];
+        for (const SpellEvent &event : events) {
+            float dx = event.x - vx, dy = event.y - vy;
+            if (event.caster == client.viewer || dx * dx + dy * dy <= eventRadiusSq) {
+                client.pendingEvents.push_back(event);
+            }
+        }
+
+        // Accumulate priority for everything in range and collect the entities that are due
+        due_.clear();
+        grid_.queryCircle(vx, vy, outerRadius, [&](uint32_t e, float x, float y) {
+            if (e == client.viewer) return;
+            float dx = x - vx, dy = y - vy;
+            float distSq = dx * dx + dy * dy;
+            float weight = 0.0f;
+            for (const InterestBand &band : config_.bands) {
+                if (distSq <= band.radius * band.radius) {
+                    weight = band.weight;
+                    break;
+                }
+            }
+            if (weight == 0.0f) return;
+
+            if (client.lastInRange[e] + 1 != world.tick) client.priority[e] = 0.0f;
+            client.lastInRange[e] = world.tick;
+            client.priority[e] += weight;
+            if (client.priority[e] >= 1.0f) due_.push_back(e);
+        });
+
+        buildPacket(client, world);
+    }
+}
+
+void InterestManager::buildPacket(Client &client, const World &world) {
+    std::vector<uint8_t> &packet = client.packet;
+    ReplicationPacket::begin(packet, world.tick);
+    int budget = config_.packetBudget - ReplicationPacket::kHeaderBytes;
+
+    // The viewer always gets its own authoritative state
+    budget -= ReplicationPacket::kEntityBytes;
+
+    // Spell events go first, oldest first; whatever does not fit waits for the next tick
+    size_t kept = 0;
+    int eventsWritten = 0;
+    for (const SpellEvent &event : client.pendingEvents) {
+        if (world.tick - event.tick > uint32_t(config_.eventLifetimeTicks)) {
+            client.stats.eventsDropped++;
+        } else if (budget >= ReplicationPacket::kEventBytes && eventsWritten < ReplicationPacket::kMaxRecords) {
+            ReplicationPacket::writeEvent(packet, event);
+            budget -= ReplicationPacket::kEventBytes;
+            eventsWritten++;
+        } else {
+            client.pendingEvents[kept++] = event;
+        }
+    }
+    client.pendingEvents.resize(kept);
+    client.stats.eventsSent += eventsWritten;
+
+    ReplicationPacket::writeEntity(packet, world, client.viewer);
+    int slots = std::min(std::max(budget, 0) / ReplicationPacket::kEntityBytes, ReplicationPacket::kMaxRecords - 1);
+    if ((int) due_.size() > slots) {
+        std::nth_element(due_.begin(), due_.begin() + slots, due_.end(), [&](EntityId a, EntityId b) {
+            return client.priority[a] > client.priority[b];
+        });
+        due_.resize(slots);
+    }
+    for (EntityId e : due_) {
+        ReplicationPacket::writeEntity(packet, world, e);
+        client.priority[e] = 0.0f;
+    }
+
+    client.stats.entitiesSent += due_.size() + 1;
+    client.stats.bytesSent += packet.size();
+    client.stats.packetsSent++;
+}
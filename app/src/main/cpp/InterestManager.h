@@ -0,0 +1,88 @@
+#ifndef MAGEVOICE_INTERESTMANAGER_H
+#define MAGEVOICE_INTERESTMANAGER_H
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "ReplicationPacket.h"
+#include "SpatialGrid.h"
+#include "World.h"
+
+// Entities within radius of the viewer gain weight priority per tick; an entity is due for an
+// update once its priority reaches 1, so weight is the update rate as a fraction of the tick rate.
+struct InterestBand {
+    float radius;
+    float weight;
+};
+
+struct InterestConfig {
+    // Sorted by radius. Entities beyond the last band are not replicated at all.
+    std::array<InterestBand, 3> bands = {{{12.0f, 1.0f}, {25.0f, 1.0f / 3.0f}, {50.0f, 1.0f / 10.0f}}};
+    // Bytes per client per tick, header included
+    int packetBudget = 400;
+    // Spell events further than this from the viewer are not sent
+    float eventRadius = 30.0f;
+    // Events that could not fit in a packet are retried for this many ticks, then dropped
+    int eventLifetimeTicks = 6;
+};
+
+struct ClientStats {
+    uint64_t bytesSent = 0;
+    uint64_t packetsSent = 0;
+    uint64_t entitiesSent = 0;
+    uint64_t eventsSent = 0;
+    uint64_t eventsDropped = 0;
+};
+
+/*!
+ * Decides per client which entities and spell events to replicate each tick.
+ *
+ * Every (client, entity) pair carries a priority accumulator fed by the distance band the entity
+ * is in. Due entities compete for the client's packet budget highest priority first; the ones
+ * that do not fit keep accumulating so they win the next ticks. The viewer's own entity and
+ * nearby spell events are always sent first.
+ */
+class InterestManager {
+public:
+    explicit InterestManager(const InterestConfig &config = InterestConfig());
+
+    // @return the client index
+    int addClient(EntityId viewer);
+
+    inline void setViewer(int client, EntityId viewer) { clients_[client].viewer = viewer; }
+
+    inline int getClientCount() const { return (int) clients_.size(); }
+
+    /*!
+     * Builds this tick's packet for every client.
+     * @param events spell events raised during world.tick
+     */
+    void update(const World &world, const std::vector<SpellEvent> &events);
+
+    inline const std::vector<uint8_t> &getPacket(int client) const { return clients_[client].packet; }
+
+    inline const ClientStats &getStats(int client) const { return clients_[client].stats; }
+
+    inline const InterestConfig &getConfig() const { return config_; }
+
+private:
+    struct Client {
+        EntityId viewer;
+        std::vector<float> priority;
+        // Tick on which the entity was last seen in range, to restart priority after it left
+        std::vector<uint32_t> lastInRange;
+        std::vector<SpellEvent> pendingEvents;
+        std::vector<uint8_t> packet;
+        ClientStats stats;
+    };
+
+    void buildPacket(Client &client, const World &world);
+
+    InterestConfig config_;
+    std::vector<Client> clients_;
+    SpatialGrid grid_;
+    std::vector<EntityId> due_;
+};
+
+#endif //MAGEVOICE_INTERESTMANAGER_H
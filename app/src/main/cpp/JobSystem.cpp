@@ -0,0 +1,228 @@
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <string>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+// Failed steal rounds before an idle worker goes to sleep
+constexpr int kIdleSpins = 64;
+
+static thread_local const JobSystem *tSystem = nullptr;
+static thread_local int tWorkerIndex = -1;
+
+// Max frequency per core; big cores report the highest value. Empty if unknown.
+static std::vector<long> readCoreFrequencies(int cores) {
+    std::vector<long> frequencies;
+    for (int cpu = 0; cpu < cores; cpu++) {
+        std::ifstream file("/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/cpufreq/cpuinfo_max_freq");
+        long khz = 0;
+        if (!(file >> khz)) return {};
+        frequencies.push_back(khz);
+    }
+    return frequencies;
+}
+
+static void pinCurrentThread(int cpu) {
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    sched_setaffinity(0, sizeof(set), &set);
+#endif
+}
+
+JobSystem::JobSystem(const JobSystemConfig &config) {
+    const int cores = std::max(1, (int) std::thread::hardware_concurrency());
+    const int threads = config.threads > 0 ? config.threads : cores;
+
+    // Cores ordered big first; a core is big if it reaches the highest max frequency
+    std::vector<int> cpus(cores);
+    std::vector<bool> cpuBig(cores, true);
+    for (int i = 0; i < cores; i++) cpus[i] = i;
+    std::vector<long> frequencies = readCoreFrequencies(cores);
+    if (!frequencies.empty()) {
+        long top = *std::max_element(frequencies.begin(), frequencies.end());
+        for (int i = 0; i < cores; i++) cpuBig[i] = frequencies[i] == top;
+        std::stable_sort(cpus.begin(), cpus.end(), [&](int a, int b) { return frequencies[a] > frequencies[b]; });
+    }
+
+    for (int i = 0; i < threads; i++) {
+        workers_.push_back(std::make_unique<Worker>());
+    }
+    // Worker 0 is the calling thread and is never pinned; it counts as big
+    if (config.pinThreads) {
+        for (int i = 1; i < threads; i++) {
+            workers_[i]->big = cpuBig[cpus[i % cores]];
+        }
+    }
+
+    tSystem = this;
+    tWorkerIndex = 0;
+    for (int i = 1; i < threads; i++) {
+        int cpu = config.pinThreads ? cpus[i % cores] : -1;
+        workers_[i]->thread = std::thread([this, i, cpu] {
+            if (cpu >= 0) pinCurrentThread(cpu);
+            tSystem = this;
+            tWorkerIndex = i;
+            workerLoop(i);
+        });
+    }
+}
+
+JobSystem::~JobSystem() {
+    running_ = false;
+    wake_.notify_all();
+    for (auto &worker : workers_) {
+        if (worker->thread.joinable()) worker->thread.join();
+    }
+    if (tSystem == this) {
+        tSystem = nullptr;
+        tWorkerIndex = -1;
+    }
+}
+
+int JobSystem::getBigWorkerCount() const {
+    int count = 0;
+    for (const auto &worker : workers_) count += worker->big;
+    return count;
+}
+
+void JobSystem::schedule(JobFunction function, void *context, int count, int grain, JobCounter &counter,
+                         CoreHint hint, JobCounter *after) {
+    if (count <= 0) return;
+    grain = std::max(1, grain);
+    counter.pending_.fetch_add((count + grain - 1) / grain, std::memory_order_relaxed);
+
+    if (after) {
+        std::lock_guard<std::mutex> lock(after->mutex_);
+        if (!after->isDone()) {
+            after->continuations_.push_back({function, context, count, grain, &counter, hint});
+            return;
+        }
+    }
+    enqueue(function, context, count, grain, &counter, hint);
+}
+
+void JobSystem::enqueue(JobFunction function, void *context, int count, int grain, JobCounter *counter, CoreHint hint) {
+    // A hint for a core class nobody runs on would strand the job
+    int big = getBigWorkerCount();
+    if ((hint == CoreHint::Big && big == 0) || (hint == CoreHint::Little && big == (int) workers_.size())) {
+        hint = CoreHint::Any;
+    }
+    for (int begin = 0; begin < count; begin += grain) {
+        push({function, context, begin, std::min(count, begin + grain), counter, hint});
+    }
+    wake_.notify_all();
+}
+
+void JobSystem::push(const Job &job) {
+    auto accepts = [&](int w) {
+        return job.hint == CoreHint::Any || (job.hint == CoreHint::Big) == workers_[w]->big;
+    };
+
+    int target = tSystem == this ? tWorkerIndex : -1;
+    if (target < 0 || !accepts(target)) {
+        const int n = (int) workers_.size();
+        int start = int(nextVictim_.fetch_add(1, std::memory_order_relaxed) % n);
+        target = start;
+        for (int i = 0; i < n; i++) {
+            int w = (start + i) % n;
+            if (accepts(w)) {
+                target = w;
+                break;
+            }
+        }
+    }
+
+    Worker &worker = *workers_[target];
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    worker.jobs.push_back(job);
+    queued_.fetch_add(1, std::memory_order_release);
+}
+
+bool JobSystem::pop(int index, Job &out) {
+    Worker &worker = *workers_[index];
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    if (worker.jobs.empty()) return false;
+    out = worker.jobs.back();
+    worker.jobs.pop_back();
+    queued_.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool JobSystem::steal(int thief, Job &out) {
+    if (queued_.load(std::memory_order_acquire) == 0) return false;
+    const bool thiefBig = workers_[thief]->big;
+    const int n = (int) workers_.size();
+    const int start = int(nextVictim_.fetch_add(1, std::memory_order_relaxed) % n);
+    for (int i = 0; i < n; i++) {
+        int victim = (start + i) % n;
+        if (victim == thief) continue;
+        Worker &worker = *workers_[victim];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        if (worker.jobs.empty()) continue;
+        const Job &front = worker.jobs.front();
+        if (front.hint != CoreHint::Any && (front.hint == CoreHint::Big) != thiefBig) continue;
+        out = front;
+        worker.jobs.pop_front();
+        queued_.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+void JobSystem::execute(const Job &job) {
+    job.function(job.context, job.begin, job.end);
+    finish(*job.counter);
+}
+
+void JobSystem::finish(JobCounter &counter) {
+    std::vector<JobCounter::Deferred> released;
+    {
+        std::lock_guard<std::mutex> lock(counter.mutex_);
+        if (counter.pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            released.swap(counter.continuations_);
+        }
+    }
+    // The counter may be gone from here on, a waiter can return as soon as the lock is released
+    for (const auto &d : released) {
+        enqueue(d.function, d.context, d.count, d.grain, d.counter, d.hint);
+    }
+}
+
+void JobSystem::wait(JobCounter &counter) {
+    const int self = tSystem == this ? tWorkerIndex : 0;
+    while (!counter.isDone()) {
+        Job job;
+        if (pop(self, job) || steal(self, job)) {
+            execute(job);
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    // Let the thread that finished the last job release the counter before it goes away
+    std::lock_guard<std::mutex> lock(counter.mutex_);
+}
+
+void JobSystem::workerLoop(int index) {
+    int idle = 0;
+    while (running_.load(std::memory_order_relaxed)) {
+        Job job;
+        if (pop(index, job) || steal(index, job)) {
+            execute(job);
+            idle = 0;
+        } else if (++idle < kIdleSpins) {
+            std::this_thread::yield();
+        } else {
+            std::unique_lock<std::mutex> lock(sleepMutex_);
+            wake_.wait_for(lock, std::chrono::milliseconds(1));
+            idle = 0;
+        }
+    }
+}
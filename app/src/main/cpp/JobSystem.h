@@ -0,0 +1,123 @@
+#ifndef MAGEVOICE_JOBSYSTEM_H
+#define MAGEVOICE_JOBSYSTEM_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Preferred core class for a job on big.LITTLE devices
+enum class CoreHint : uint8_t {
+    Any,
+    Big,   // Latency sensitive work: simulation stages on the critical path
+    Little // Background work: network encoding, asset decoding
+};
+
+using JobFunction = void (*)(void *context, int begin, int end);
+
+/*!
+ * Counts the unfinished jobs of a stage. Other stages can be scheduled "after" a counter; they
+ * are held here and released when it reaches zero.
+ */
+class JobCounter {
+public:
+    inline bool isDone() const { return pending_.load(std::memory_order_acquire) == 0; }
+
+private:
+    friend class JobSystem;
+
+    struct Deferred {
+        JobFunction function;
+        void *context;
+        int count;
+        int grain;
+        JobCounter *counter;
+        CoreHint hint;
+    };
+
+    std::atomic<int> pending_{0};
+    std::mutex mutex_;
+    std::vector<Deferred> continuations_;
+};
+
+struct JobSystemConfig {
+    // Threads running jobs, including the one that calls wait(). 0 uses every core.
+    int threads = 0;
+    // Pin workers to cores (big cores first). Core hints only take effect on pinned workers.
+    bool pinThreads = false;
+};
+
+/*!
+ * Work-stealing job system.
+ *
+ * Every worker owns a deque: it pushes and pops its own jobs at the back and idle workers steal
+ * from the front of the others. The thread that created the system is worker 0 and runs jobs
+ * while it waits on a counter, so a system with one thread executes everything inline.
+ */
+class JobSystem {
+public:
+    explicit JobSystem(const JobSystemConfig &config = JobSystemConfig());
+    ~JobSystem();
+
+    /*!
+     * Splits [0, count) into chunks of at most grain items and runs function(context, begin, end)
+     * on each. context must stay valid until counter is done.
+     * @param after if not null, the chunks only start once this counter is done
+     */
+    void schedule(JobFunction function, void *context, int count, int grain, JobCounter &counter,
+                  CoreHint hint = CoreHint::Any, JobCounter *after = nullptr);
+
+    // Runs jobs on the calling thread until the counter is done
+    void wait(JobCounter &counter);
+
+    // Blocking parallel loop, fn(begin, end) is called for every chunk
+    template<typename Fn>
+    void parallelFor(int count, int grain, Fn &&fn, CoreHint hint = CoreHint::Any) {
+        JobCounter counter;
+        schedule([](void *context, int begin, int end) { (*static_cast<Fn *>(context))(begin, end); },
+                 &fn, count, grain, counter, hint);
+        wait(counter);
+    }
+
+    inline int getThreadCount() const { return (int) workers_.size(); }
+
+    // Number of workers running on big cores; equals getThreadCount() when cores are uniform
+    int getBigWorkerCount() const;
+
+private:
+    struct Job {
+        JobFunction function;
+        void *context;
+        int begin;
+        int end;
+        JobCounter *counter;
+        CoreHint hint;
+    };
+
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+        std::thread thread;
+        bool big = true;
+    };
+
+    void push(const Job &job);
+    bool pop(int worker, Job &out);
+    bool steal(int thief, Job &out);
+    void execute(const Job &job);
+    void finish(JobCounter &counter);
+    void enqueue(JobFunction function, void *context, int count, int grain, JobCounter *counter, CoreHint hint);
+    void workerLoop(int index);
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::atomic<bool> running_{true};
+    std::atomic<int> queued_{0};
+    std::atomic<uint32_t> nextVictim_{0};
+    std::mutex sleepMutex_;
+    std::condition_variable wake_;
+};
+
+#endif //MAGEVOICE_JOBSYSTEM_H
@@ -0,0 +1,152 @@
+#include "KeywordSpotter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// Cepstra c1..c12 are matched; c0 only tracks loudness and is used for trimming
+constexpr int kDims = 12;
+constexpr int kMinTemplateFrames = 5;
+constexpr float kInfinity = std::numeric_limits<float>::infinity();
+
+static inline float frameDistance(const float *a, const float *b) {
+    float sum = 0.0f;
+    for (int i = 0; i < kDims; i++) {
+        float d = a[i] - b[i];
+        sum += d * d;
+    }
+    return std::sqrt(sum);
+}
+
+KeywordSpotter::KeywordSpotter(const SpotterConfig &config, const FeatureConfig &featureConfig) :
+    config_(config),
+    extractor_(featureConfig),
+    frameCount_(0),
+    refractory_(0) {}
+
+bool KeywordSpotter::addTemplate(int keyword, const int16_t *pcm, int count) {
+    const FeatureConfig &fc = extractor_.getConfig();
+    if (fc.mfccCount < kDims + 1) return false;
+
+    FeatureExtractor extractor(fc);
+    std::vector<float> features;
+    int frames = extractor.process(pcm, count, features);
+    if (frames < kMinTemplateFrames) return false;
+
+    // c0 = sqrt(2 / bands) * sum(logMel), convert back to the mean log-mel energy
+    const float c0ToMean = 1.0f / (std::sqrt(2.0f / fc.melBands) * fc.melBands);
+    float loudest = -kInfinity;
+    for (int f = 0; f < frames; f++) {
+        loudest = std::max(loudest, features[f * fc.mfccCount] * c0ToMean);
+    }
+    int first = 0, last = frames - 1;
+    while (first < last && features[first * fc.mfccCount] * c0ToMean < loudest - config_.trimRange) first++;
+    while (last > first && features[last * fc.mfccCount] * c0ToMean < loudest - config_.trimRange) last--;
+    int length = last - first + 1;
+    if (length < kMinTemplateFrames) return false;
+
+    Template t;
+    t.keyword = keyword;
+    t.length = length;
+    t.endIndex = std::clamp(int(std::ceil(config_.matchFraction * length)) - 1, 0, length - 1);
+    t.frames.resize(length * kDims);
+    for (int f = 0; f < length; f++) {
+        const float *src = features.data() + (first + f) * fc.mfccCount + 1;
+        std::copy(src, src + kDims, t.frames.begin() + f * kDims);
+    }
+    t.cost.assign(length, kInfinity);
+    t.pathLength.assign(length, 0);
+    templates_.push_back(std::move(t));
+    return true;
+}
+
+void KeywordSpotter::reset() {
+    extractor_.reset();
+    clearMatches();
+    refractory_ = 0;
+}
+
+void KeywordSpotter::clearMatches() {
+    for (auto &t : templates_) {
+        std::fill(t.cost.begin(), t.cost.end(), kInfinity);
+        std::fill(t.pathLength.begin(), t.pathLength.end(), 0);
+    }
+}
+
+int KeywordSpotter::process(const int16_t *pcm, int count, std::vector<KeywordDetection> &outDetections) {
+    const int dims = extractor_.getConfig().mfccCount;
+    features_.clear();
+    int frames = extractor_.process(pcm, count, features_);
+
+    int detections = 0;
+    for (int f = 0; f < frames; f++) {
+        KeywordDetection detection;
+        if (step(features_.data() + f * dims, detection)) {
+            outDetections.push_back(detection);
+            detections++;
+        }
+    }
+    return detections;
+}
+
+bool KeywordSpotter::step(const float *mfcc, KeywordDetection &outDetection) {
+    const int64_t frame = frameCount_++;
+    const float *x = mfcc + 1;
+
+    float bestConfidence = 0.0f;
+    int bestKeyword = -1;
+
+    for (auto &t : templates_) {
+        float *cost = t.cost.data();
+        int *pathLength = t.pathLength.data();
+
+        // Walk the column backwards so cost[i - 1] and cost[i - 2] still hold the previous frame.
+        // Allowed moves: stay on the template frame, advance one, or skip one. A match may start
+        // on any stream frame (subsequence alignment).
+        for (int i = t.length - 1; i >= 0; i--) {
+            float d = frameDistance(x, t.frames.data() + i * kDims);
+
+            float bestCost = kInfinity;
+            int bestLength = 0;
+            float bestAverage = kInfinity;
+            auto consider = [&](float c, int len) {
+                if (c == kInfinity) return;
+                float average = (c + d) / float(len + 1);
+                if (average < bestAverage) {
+                    bestAverage = average;
+                    bestCost = c + d;
+                    bestLength = len + 1;
+                }
+            };
+            consider(cost[i], pathLength[i]);
+            if (i >= 1) consider(cost[i - 1], pathLength[i - 1]);
+            if (i >= 2) consider(cost[i - 2], pathLength[i - 2]);
+            if (i == 0) consider(0.0f, 0);
+
+            cost[i] = bestCost;
+            pathLength[i] = bestLength;
+        }
+
+        if (refractory_ == 0 && pathLength[t.endIndex] > 0) {
+            float average = cost[t.endIndex] / pathLength[t.endIndex];
+            float confidence = std::exp(-average / config_.costScale);
+            if (confidence > bestConfidence) {
+                bestConfidence = confidence;
+                bestKeyword = t.keyword;
+            }
+        }
+    }
+
+    if (refractory_ > 0) {
+        refractory_--;
+        return false;
+    }
+    if (bestKeyword < 0 || bestConfidence < config_.threshold) return false;
+
+    outDetection.keyword = bestKeyword;
+    outDetection.confidence = bestConfidence;
+    outDetection.frame = frame;
+    refractory_ = config_.refractoryFrames;
+    clearMatches();
+    return true;
+}
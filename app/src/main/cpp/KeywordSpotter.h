@@ -0,0 +1,86 @@
+#ifndef MAGEVOICE_KEYWORDSPOTTER_H
+#define MAGEVOICE_KEYWORDSPOTTER_H
+
+#include <cstdint>
+#include <vector>
+
+#include "AudioFeatures.h"
+
+struct SpotterConfig {
+    // Minimum confidence in (0, 1] for a detection to fire
+    float threshold = 0.35f;
+    // Average per-frame cepstral distance that maps to a confidence of 1/e
+    float costScale = 15.0f;
+    // Fraction of a template that must be matched; below 1 fires before the word has ended
+    float matchFraction = 0.85f;
+    // Frames ignored after a detection so one utterance casts once
+    int refractoryFrames = 30;
+    // Template frames quieter than the loudest by more than this (mean log-mel, in nats) are trimmed
+    float trimRange = 5.0f;
+};
+
+struct KeywordDetection {
+    int keyword;
+    float confidence;
+    // Index of the feature frame (hop) on which the detection fired
+    int64_t frame;
+};
+
+/*!
+ * Small-vocabulary streaming keyword spotter.
+ *
+ * Each keyword is "trained" by enrolling one or more recordings. Incoming audio is turned into
+ * MFCC frames and aligned against every template with a subsequence DTW that advances one column
+ * per 10 ms hop, so a detection fires on the frame where the running match first crosses the
+ * confidence threshold instead of after the utterance has been transcribed.
+ */
+class KeywordSpotter {
+public:
+    explicit KeywordSpotter(const SpotterConfig &config = SpotterConfig(),
+                            const FeatureConfig &featureConfig = FeatureConfig());
+
+    /*!
+     * Enrolls a recording of a keyword. Leading and trailing silence is trimmed.
+     * @return false if the recording holds too little speech to be used
+     */
+    bool addTemplate(int keyword, const int16_t *pcm, int count);
+
+    /*!
+     * Consumes 16-bit PCM at the feature sample rate.
+     * @param outDetections detections fired while consuming this chunk are appended here
+     * @return the number of detections appended
+     */
+    int process(const int16_t *pcm, int count, std::vector<KeywordDetection> &outDetections);
+
+    // Clears the audio buffer and all partial matches, keeping the templates
+    void reset();
+
+    inline int getTemplateCount() const { return (int) templates_.size(); }
+    inline int64_t getFrameCount() const { return frameCount_; }
+    inline const SpotterConfig &getConfig() const { return config_; }
+    inline const FeatureConfig &getFeatureConfig() const { return extractor_.getConfig(); }
+
+private:
+    struct Template {
+        int keyword;
+        int length;
+        int endIndex;
+        // length x kDims cepstra, c0 dropped
+        std::vector<float> frames;
+        // DTW column: accumulated cost and path length ending at each template frame
+        std::vector<float> cost;
+        std::vector<int> pathLength;
+    };
+
+    void clearMatches();
+    bool step(const float *mfcc, KeywordDetection &outDetection);
+
+    SpotterConfig config_;
+    FeatureExtractor extractor_;
+    std::vector<Template> templates_;
+    std::vector<float> features_;
+    int64_t frameCount_;
+    int refractory_;
+};
+
+#endif //MAGEVOICE_KEYWORDSPOTTER_H
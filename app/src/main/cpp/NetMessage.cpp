@@ -0,0 +1,60 @@
+#include "NetMessage.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "WireFormat.h"
+
+// Joystick axis in [-1, 1] as a signed byte
+static uint8_t putAxis(float v) { return uint8_t(int8_t(std::clamp(std::round(v * 127.0f), -127.0f, 127.0f))); }
+
+static float getAxis(uint8_t v) { return int8_t(v) / 127.0f; }
+
+void NetMessage::writeJoin(std::vector<uint8_t> &out) {
+    out.assign(1, static_cast<uint8_t>(NetMessageType::Join));
+}
+
+void NetMessage::writeLeave(std::vector<uint8_t> &out) {
+    out.assign(1, static_cast<uint8_t>(NetMessageType::Leave));
+}
+
+void NetMessage::writeInput(std::vector<uint8_t> &out, const ClientInput &input) {
+    out.assign(1, static_cast<uint8_t>(NetMessageType::Input));
+    WireFormat::put32(out, input.sequence);
+    out.push_back(putAxis(input.moveX));
+    out.push_back(putAxis(input.moveY));
+    out.push_back(static_cast<uint8_t>(input.spell));
+    WireFormat::putPosition(out, input.targetX);
+    WireFormat::putPosition(out, input.targetY);
+    WireFormat::put32(out, input.viewTick);
+}
+
+bool NetMessage::readInput(const uint8_t *data, size_t size, ClientInput &outInput) {
+    if (size < size_t(kInputBytes) || data[0] != static_cast<uint8_t>(NetMessageType::Input)) return false;
+    outInput.sequence = WireFormat::get32(data + 1);
+    outInput.moveX = getAxis(data[5]);
+    outInput.moveY = getAxis(data[6]);
+    outInput.spell = data[7] < kSpellTypeCount ? static_cast<SpellType>(data[7]) : SpellType::Count;
+    outInput.targetX = WireFormat::getPosition(data + 8);
+    outInput.targetY = WireFormat::getPosition(data + 10);
+    outInput.viewTick = WireFormat::get32(data + 12);
+    return true;
+}
+
+void NetMessage::writeWelcome(std::vector<uint8_t> &out, EntityId entity, uint32_t tick) {
+    out.assign(1, static_cast<uint8_t>(NetMessageType::Welcome));
+    WireFormat::put16(out, uint16_t(entity));
+    WireFormat::put32(out, tick);
+}
+
+bool NetMessage::readWelcome(const uint8_t *data, size_t size, EntityId &outEntity, uint32_t &outTick) {
+    if (size < size_t(kWelcomeBytes) || data[0] != static_cast<uint8_t>(NetMessageType::Welcome)) return false;
+    outEntity = WireFormat::get16(data + 1);
+    outTick = WireFormat::get32(data + 3);
+    return true;
+}
+
+void NetMessage::writeState(std::vector<uint8_t> &out, const std::vector<uint8_t> &replication) {
+    out.assign(1, static_cast<uint8_t>(NetMessageType::State));
+    out.insert(out.end(), replication.begin(), replication.end());
+}
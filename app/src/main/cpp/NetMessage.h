@@ -0,0 +1,62 @@
+#ifndef MAGEVOICE_NETMESSAGE_H
+#define MAGEVOICE_NETMESSAGE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "SpellType.h"
+#include "World.h"
+
+// First byte of every datagram between a client and the authoritative server
+enum class NetMessageType : uint8_t {
+    Join = 1,    // client -> server, no payload
+    Input = 2,   // client -> server, ClientInput
+    Leave = 3,   // client -> server, no payload
+    Welcome = 4, // server -> client, the entity the client controls
+    State = 5    // server -> client, a ReplicationPacket
+};
+
+// Latest controls of one client. The server keeps the newest by sequence and ignores older ones.
+struct ClientInput {
+    uint32_t sequence = 0;
+    // Joystick in [-1, 1] along the world axes (+y is up)
+    float moveX = 0.0f;
+    float moveY = 0.0f;
+    // SpellType::Count when the input does not cast anything
+    SpellType spell = SpellType::Count;
+    float targetX = 0.0f;
+    float targetY = 0.0f;
+    // Tick of the newest state the client had when it aimed; the server rewinds hit tests to it
+    uint32_t viewTick = 0;
+};
+
+/*!
+ * Encoding of the client/server datagrams; the state payload itself is a ReplicationPacket.
+ *
+ * Layout (little endian) after the type byte: Input is sequence u32, move x i8, move y i8,
+ * spell u8, target x i16, target y i16 (WireFormat fixed point), view tick u32.
+ * Welcome is entity u16, tick u32.
+ */
+class NetMessage {
+public:
+    static constexpr int kInputBytes = 16;
+    static constexpr int kWelcomeBytes = 7;
+
+    // Type of the datagram, or 0 if it is empty
+    static inline uint8_t type(const uint8_t *data, size_t size) { return size > 0 ? data[0] : 0; }
+
+    static void writeJoin(std::vector<uint8_t> &out);
+    static void writeLeave(std::vector<uint8_t> &out);
+
+    static void writeInput(std::vector<uint8_t> &out, const ClientInput &input);
+    static bool readInput(const uint8_t *data, size_t size, ClientInput &outInput);
+
+    static void writeWelcome(std::vector<uint8_t> &out, EntityId entity, uint32_t tick);
+    static bool readWelcome(const uint8_t *data, size_t size, EntityId &outEntity, uint32_t &outTick);
+
+    // Type byte followed by the ReplicationPacket bytes
+    static void writeState(std::vector<uint8_t> &out, const std::vector<uint8_t> &replication);
+};
+
+#endif //MAGEVOICE_NETMESSAGE_H
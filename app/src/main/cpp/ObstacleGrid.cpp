@@ -0,0 +1,88 @@
+#include "ObstacleGrid.h"
+
+#include <algorithm>
+
+// Gap left between a stopped player and the wall, so the next test does not count it as touching
+constexpr float kContactGap = 1e-3f;
+
+void ObstacleGrid::resize(int width, int height, float tileSize, float originX, float originY) {
+    width_ = width;
+    height_ = height;
+    wordsPerRow_ = (width + 63) / 64;
+    tileSize_ = tileSize;
+    inverseTileSize_ = 1.0f / tileSize;
+    originX_ = originX;
+    originY_ = originY;
+    words_.assign(size_t(wordsPerRow_) * height, 0);
+}
+
+bool ObstacleGrid::anyBlocked(int x0, int x1, int y0, int y1) const {
+    if (x0 < 0 || y0 < 0 || x1 >= width_ || y1 >= height_) return true;
+    const int w0 = x0 >> 6, w1 = x1 >> 6;
+    for (int y = y0; y <= y1; y++) {
+        const uint64_t *row = words_.data() + size_t(y) * wordsPerRow_;
+        for (int w = w0; w <= w1; w++) {
+            // Bits x0..x1 that fall inside word w
+            uint64_t mask = ~uint64_t(0);
+            if (w == w0) mask &= ~uint64_t(0) << (x0 & 63);
+            if (w == w1 && (x1 & 63) != 63) mask &= (uint64_t(1) << ((x1 & 63) + 1)) - 1;
+            if (row[w] & mask) return true;
+        }
+    }
+    return false;
+}
+
+bool ObstacleGrid::overlaps(float x, float y, float halfSize) const {
+    return anyBlocked(tileX(x - halfSize), tileX(x + halfSize), tileY(y - halfSize), tileY(y + halfSize));
+}
+
+float ObstacleGrid::sweepX(float x, float y, float dx, float halfSize) const {
+    const int y0 = tileY(y - halfSize), y1 = tileY(y + halfSize);
+    // Walk the columns the leading side crosses and stop before the first blocked one
+    if (dx > 0.0f) {
+        const int last = tileX(x + dx + halfSize);
+        for (int c = tileX(x + halfSize); c <= last; c++) {
+            if (anyBlocked(c, c, y0, y1)) return std::max(x, originX_ + c * tileSize_ - halfSize - kContactGap);
+        }
+    } else {
+        const int last = tileX(x + dx - halfSize);
+        for (int c = tileX(x - halfSize); c >= last; c--) {
+            if (anyBlocked(c, c, y0, y1)) {
+                return std::min(x, originX_ + (c + 1) * tileSize_ + halfSize + kContactGap);
+            }
+        }
+    }
+    return x + dx;
+}
+
+float ObstacleGrid::sweepY(float x, float y, float dy, float halfSize) const {
+    const int x0 = tileX(x - halfSize), x1 = tileX(x + halfSize);
+    if (dy > 0.0f) {
+        const int last = tileY(y + dy + halfSize);
+        for (int r = tileY(y + halfSize); r <= last; r++) {
+            if (anyBlocked(x0, x1, r, r)) return std::max(y, originY_ + r * tileSize_ - halfSize - kContactGap);
+        }
+    } else {
+        const int last = tileY(y + dy - halfSize);
+        for (int r = tileY(y - halfSize); r >= last; r--) {
+            if (anyBlocked(x0, x1, r, r)) {
+                return std::min(y, originY_ + (r + 1) * tileSize_ + halfSize + kContactGap);
+            }
+        }
+    }
+    return y + dy;
+}
+
+void ObstacleGrid::slide(float &x, float &y, float dx, float dy, float halfSize) const {
+    if (dx != 0.0f) {
+        float nx = sweepX(x, y, dx, halfSize);
+        // Rounding at the contact gap can still leave it touching; then it does not move
+        if (overlaps(nx, y, halfSize)) nx = x;
+        x = nx;
+    }
+    if (dy != 0.0f) {
+        float ny = sweepY(x, y, dy, halfSize);
+        if (overlaps(x, ny, halfSize)) ny = y;
+        y = ny;
+    }
+}
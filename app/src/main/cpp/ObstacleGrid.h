@@ -0,0 +1,73 @@
+#ifndef MAGEVOICE_OBSTACLEGRID_H
+#define MAGEVOICE_OBSTACLEGRID_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*!
+ * One bit per map tile, set where movement is blocked.
+ *
+ * Rows are packed into 64-bit words, so testing the few tiles under a player is a handful of
+ * mask tests on one or two cache lines. Everything outside the map counts as blocked, which
+ * makes the map edge a wall without special cases.
+ */
+class ObstacleGrid {
+public:
+    /*!
+     * Clears the grid to all free.
+     * @param originX, originY world position of the bottom-left corner of tile (0, 0)
+     */
+    void resize(int width, int height, float tileSize, float originX, float originY);
+
+    inline bool isBlocked(int tileX, int tileY) const {
+        if (tileX < 0 || tileY < 0 || tileX >= width_ || tileY >= height_) return true;
+        return (words_[size_t(tileY) * wordsPerRow_ + (tileX >> 6)] >> (tileX & 63)) & 1u;
+    }
+
+    inline void setBlocked(int tileX, int tileY, bool blocked) {
+        uint64_t &word = words_[size_t(tileY) * wordsPerRow_ + (tileX >> 6)];
+        uint64_t bit = uint64_t(1) << (tileX & 63);
+        word = blocked ? (word | bit) : (word & ~bit);
+    }
+
+    // True if the square of the given half size centred on (x, y) touches a blocked tile
+    bool overlaps(float x, float y, float halfSize) const;
+
+    /*!
+     * Moves the square by (dx, dy) one axis at a time. Each axis move is swept across every
+     * tile it passes, so a long move cannot skip over a thin wall; it stops flush against the
+     * first blocked tile on its path, so players slide along walls.
+     */
+    void slide(float &x, float &y, float dx, float dy, float halfSize) const;
+
+    inline int getWidth() const { return width_; }
+
+    inline int getHeight() const { return height_; }
+
+    inline size_t getByteSize() const { return words_.size() * sizeof(uint64_t); }
+
+private:
+    inline int tileX(float x) const { return (int) std::floor((x - originX_) * inverseTileSize_); }
+
+    inline int tileY(float y) const { return (int) std::floor((y - originY_) * inverseTileSize_); }
+
+    bool anyBlocked(int x0, int x1, int y0, int y1) const;
+
+    // Where a move along one axis ends, short of the first blocked tile it would cross
+    float sweepX(float x, float y, float dx, float halfSize) const;
+
+    float sweepY(float x, float y, float dy, float halfSize) const;
+
+    int width_ = 0;
+    int height_ = 0;
+    int wordsPerRow_ = 0;
+    float tileSize_ = 1.0f;
+    float inverseTileSize_ = 1.0f;
+    float originX_ = 0.0f;
+    float originY_ = 0.0f;
+    std::vector<uint64_t> words_;
+};
+
+#endif //MAGEVOICE_OBSTACLEGRID_H
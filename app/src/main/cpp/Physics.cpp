@@ -0,0 +1,54 @@
+#include "Physics.h"
+
+#include <algorithm>
+#include <cmath>
+
+void Physics::move(World &world, int begin, int end, float dt, float halfExtent) {
+    for (int e = begin; e < end; e++) {
+        if (!world.alive[e]) continue;
+        float step = kPlayerSpeed * world.speedMultiplier(e) * dt;
+        world.posX[e] = std::clamp(world.posX[e] + world.velX[e] * step, -halfExtent, halfExtent);
+        world.posY[e] = std::clamp(world.posY[e] + world.velY[e] * step, -halfExtent, halfExtent);
+    }
+}
+
+void Physics::move(World &world, int begin, int end, float dt, const ObstacleGrid &obstacles) {
+    for (int e = begin; e < end; e++) {
+        if (!world.alive[e]) continue;
+        float step = kPlayerSpeed * world.speedMultiplier(e) * dt;
+        obstacles.slide(world.posX[e], world.posY[e], world.velX[e] * step, world.velY[e] * step, kPlayerRadius);
+    }
+}
+
+void Physics::separate(const World &world, const SpatialGrid &grid, int begin, int end, float *outX, float *outY) {
+    const float minDistance = 2.0f * kPlayerRadius;
+    const float minDistanceSq = minDistance * minDistance;
+    const std::vector<uint32_t> &entries = grid.getEntries();
+    for (int i = begin; i < end; i++) {
+        const uint32_t e = entries[i];
+        const float x = world.posX[e];
+        const float y = world.posY[e];
+        float pushX = 0.0f, pushY = 0.0f;
+        if (world.alive[e]) {
+            grid.queryCircle(x, y, minDistance, [&](uint32_t other, float otherX, float otherY) {
+                if (other == e || !world.alive[other]) return;
+                float dx = x - otherX;
+                float dy = y - otherY;
+                float distSq = dx * dx + dy * dy;
+                if (distSq >= minDistanceSq) return;
+                if (distSq < 1e-12f) {
+                    // Exactly stacked: split them along x by index so both do not move the same way
+                    pushX += e < other ? -0.5f * minDistance : 0.5f * minDistance;
+                    return;
+                }
+                float dist = std::sqrt(distSq);
+                // Each side moves half the overlap
+                float scale = 0.5f * (minDistance - dist) / dist;
+                pushX += dx * scale;
+                pushY += dy * scale;
+            });
+        }
+        outX[e] = x + pushX;
+        outY[e] = y + pushY;
+    }
+}
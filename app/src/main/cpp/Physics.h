@@ -0,0 +1,35 @@
+#ifndef MAGEVOICE_PHYSICS_H
+#define MAGEVOICE_PHYSICS_H
+
+#include "ObstacleGrid.h"
+#include "SpatialGrid.h"
+#include "World.h"
+
+/*!
+ * Per-entity simulation passes. Each works on an entity range and only writes to that range,
+ * so the job system can split them across cores.
+ */
+class Physics {
+public:
+    // Player footprint used for separation, matches the 1x1 player quad
+    static constexpr float kPlayerRadius = 0.5f;
+
+    /*!
+     * Moves entities by their velocity (joystick units, scaled by kPlayerSpeed and any slow)
+     * and keeps them inside the square of the given half extent.
+     */
+    static void move(World &world, int begin, int end, float dt, float halfExtent = kMapSize * 0.5f);
+
+    // Same as move, but players slide along the solid tiles of the map instead of a square edge
+    static void move(World &world, int begin, int end, float dt, const ObstacleGrid &obstacles);
+
+    /*!
+     * Computes where entities end up after being pushed out of the players overlapping them.
+     * Only reads the world, results go to outX/outY (indexed by entity).
+     * @param grid built over the current positions with a cell size of at least 2 * kPlayerRadius
+     * @param begin, end range of grid.getEntries() to process; grid order keeps lookups local
+     */
+    static void separate(const World &world, const SpatialGrid &grid, int begin, int end, float *outX, float *outY);
+};
+
+#endif //MAGEVOICE_PHYSICS_H
@@ -0,0 +1,37 @@
+#include "PositionHistory.h"
+
+#include <algorithm>
+
+PositionHistory::PositionHistory(int depth, float cellSize) { reset(depth, cellSize); }
+
+void PositionHistory::reset(int depth, float cellSize) {
+    slots_.assign(std::max(depth, 1), Slot());
+    cellSize_ = cellSize;
+    newestTick_ = 0;
+    recorded_ = 0;
+}
+
+void PositionHistory::record(const World &world) {
+    const uint32_t tick = world.tick;
+    if (recorded_ > 0 && tick == newestTick_ + 1) {
+        recorded_ = std::min(recorded_ + 1, getDepth());
+    } else if (recorded_ == 0 || tick != newestTick_) {
+        // First record or a jump in time: the older slots no longer hold consecutive ticks
+        recorded_ = 1;
+    }
+    newestTick_ = tick;
+
+    Slot &s = slots_[tick % slots_.size()];
+    s.x.assign(world.posX.begin(), world.posX.end());
+    s.y.assign(world.posY.begin(), world.posY.end());
+    s.alive.assign(world.alive.begin(), world.alive.end());
+    s.grid.build(s.x.data(), s.y.data(), world.size(), cellSize_);
+}
+
+size_t PositionHistory::getByteSize() const {
+    size_t bytes = 0;
+    for (const Slot &s : slots_) {
+        bytes += (s.x.capacity() + s.y.capacity()) * sizeof(float) + s.alive.capacity() + s.grid.getByteSize();
+    }
+    return bytes;
+}
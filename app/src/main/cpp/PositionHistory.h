@@ -0,0 +1,91 @@
+#ifndef MAGEVOICE_POSITIONHISTORY_H
+#define MAGEVOICE_POSITIONHISTORY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "SpatialGrid.h"
+#include "World.h"
+
+/*!
+ * Ring buffer of the entity positions of the last few ticks, for lag compensated hit tests.
+ *
+ * record() copies the positions and alive flags of the world at its tick into the oldest slot
+ * and builds a SpatialGrid over them, so a query at a past tick costs the same as one against
+ * the present. Only ticks within getDepth() of the newest recorded one can be rewound to;
+ * clampTick() bounds a request to what is stored.
+ */
+class PositionHistory {
+public:
+    /*!
+     * @param depth number of ticks kept, at least 1
+     * @param cellSize grid cell edge; use the largest query radius
+     */
+    explicit PositionHistory(int depth = 1, float cellSize = 1.0f);
+
+    // Drops every recorded tick
+    void reset(int depth, float cellSize);
+
+    // Stores the world as it is at world.tick, replacing the oldest tick once the ring is full
+    void record(const World &world);
+
+    inline bool isEmpty() const { return recorded_ == 0; }
+
+    inline int getDepth() const { return (int) slots_.size(); }
+
+    inline uint32_t getNewestTick() const { return newestTick_; }
+
+    inline uint32_t getOldestTick() const { return newestTick_ - uint32_t(recorded_ - 1); }
+
+    inline bool has(uint32_t tick) const {
+        return recorded_ > 0 && tick <= newestTick_ && newestTick_ - tick < uint32_t(recorded_);
+    }
+
+    // Nearest recorded tick; the history must not be empty
+    inline uint32_t clampTick(uint32_t tick) const {
+        uint32_t oldest = getOldestTick();
+        return tick < oldest ? oldest : (tick > newestTick_ ? newestTick_ : tick);
+    }
+
+    // Entities that existed at the tick; later ones have no position there
+    inline int getEntityCount(uint32_t tick) const { return (int) slot(tick).x.size(); }
+
+    inline float getX(uint32_t tick, EntityId e) const { return slot(tick).x[e]; }
+
+    inline float getY(uint32_t tick, EntityId e) const { return slot(tick).y[e]; }
+
+    inline bool wasAlive(uint32_t tick, EntityId e) const { return slot(tick).alive[e] != 0; }
+
+    /*!
+     * Calls visit(entity, x, y) with the position at the tick of every entity alive then, in the
+     * cells overlapping the circle. Like SpatialGrid::queryCircle, callers test the exact distance.
+     */
+    template<typename Visitor>
+    void queryCircle(uint32_t tick, float cx, float cy, float radius, Visitor &&visit) const {
+        const Slot &s = slot(tick);
+        s.grid.queryCircle(cx, cy, radius, [&](uint32_t e, float x, float y) {
+            if (s.alive[e]) visit(e, x, y);
+        });
+    }
+
+    // Heap bytes held by the recorded ticks
+    size_t getByteSize() const;
+
+private:
+    struct Slot {
+        std::vector<float> x;
+        std::vector<float> y;
+        std::vector<uint8_t> alive;
+        SpatialGrid grid;
+    };
+
+    inline const Slot &slot(uint32_t tick) const { return slots_[tick % slots_.size()]; }
+
+    std::vector<Slot> slots_;
+    float cellSize_;
+    uint32_t newestTick_ = 0;
+    int recorded_ = 0;
+};
+
+#endif //MAGEVOICE_POSITIONHISTORY_H
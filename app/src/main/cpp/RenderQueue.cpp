@@ -0,0 +1,91 @@
+#include "RenderQueue.h"
+
+#include <cstddef>
+#include <utility>
+
+void RenderQueue::beginFrame(int producers) {
+    if ((int) buffers_.size() < producers) buffers_.resize(producers);
+    for (auto &buffer : buffers_) buffer.commands_.clear();
+    sorted_.clear();
+    merged_ = false;
+}
+
+void RenderQueue::merge() {
+    sorted_.clear();
+    for (uint32_t b = 0; b < buffers_.size(); b++) {
+        const auto &commands = buffers_[b].commands_;
+        for (uint32_t i = 0; i < commands.size(); i++) {
+            sorted_.push_back({commands[i].key, b, i});
+        }
+    }
+    merged_ = true;
+}
+
+void RenderQueue::sort() {
+    merge();
+    const size_t count = sorted_.size();
+    if (count < 2) return;
+
+    // LSD radix sort, one byte per pass. Histograms for all bytes come from a single read, and a
+    // pass is skipped when every key has the same value in that byte.
+    uint32_t histogram[8][256] = {};
+    for (const Entry &e : sorted_) {
+        for (int pass = 0; pass < 8; pass++) {
+            histogram[pass][(e.key >> (pass * 8)) & 0xFF]++;
+        }
+    }
+
+    scratch_.resize(count);
+    Entry *source = sorted_.data();
+    Entry *target = scratch_.data();
+    for (int pass = 0; pass < 8; pass++) {
+        uint32_t *counts = histogram[pass];
+        if (counts[(source[0].key >> (pass * 8)) & 0xFF] == count) continue;
+
+        uint32_t offset = 0;
+        for (int b = 0; b < 256; b++) {
+            uint32_t c = counts[b];
+            counts[b] = offset;
+            offset += c;
+        }
+        for (size_t i = 0; i < count; i++) {
+            target[counts[(source[i].key >> (pass * 8)) & 0xFF]++] = source[i];
+        }
+        std::swap(source, target);
+    }
+    if (source != sorted_.data()) sorted_.swap(scratch_);
+}
+
+RenderStats RenderQueue::execute(RenderBackend &backend) {
+    if (!merged_) merge();
+
+    RenderStats stats;
+    bool first = true;
+    uint8_t shader = 0, mesh = 0;
+    uint16_t texture = 0;
+    for (const Entry &e : sorted_) {
+        const RenderCommand &command = buffers_[e.buffer].commands_[e.index];
+        uint8_t s = RenderKey::shader(e.key);
+        uint16_t t = RenderKey::texture(e.key);
+        uint8_t m = RenderKey::mesh(e.key);
+        if (first || s != shader) {
+            backend.bindShader(s);
+            shader = s;
+            stats.shaderChanges++;
+        }
+        if (first || t != texture) {
+            backend.bindTexture(t);
+            texture = t;
+            stats.textureChanges++;
+        }
+        if (first || m != mesh) {
+            backend.bindMesh(m);
+            mesh = m;
+            stats.meshChanges++;
+        }
+        first = false;
+        backend.draw(command);
+        stats.draws++;
+    }
+    return stats;
+}
@@ -0,0 +1,117 @@
+#ifndef MAGEVOICE_RENDERQUEUE_H
+#define MAGEVOICE_RENDERQUEUE_H
+
+#include <cstdint>
+#include <vector>
+
+/*!
+ * 64-bit sort key, most significant field first:
+ *   layer (8) | shader (8) | texture (16) | depth (24) | mesh (8)
+ * Sorting by key draws layer by layer and, inside a layer, groups draws by shader then texture.
+ * Depth is front to back; for blended layers pass 1 - depth to draw back to front.
+ */
+class RenderKey {
+public:
+    static inline uint64_t make(uint8_t layer, uint8_t shader, uint16_t texture, float depth, uint8_t mesh) {
+        float clamped = depth < 0.0f ? 0.0f : (depth > 1.0f ? 1.0f : depth);
+        uint64_t quantized = uint64_t(clamped * float(kDepthMax));
+        return (uint64_t(layer) << 56) | (uint64_t(shader) << 48) | (uint64_t(texture) << 32)
+               | (quantized << 8) | uint64_t(mesh);
+    }
+
+    static inline uint8_t layer(uint64_t key) { return uint8_t(key >> 56); }
+    static inline uint8_t shader(uint64_t key) { return uint8_t(key >> 48); }
+    static inline uint16_t texture(uint64_t key) { return uint16_t(key >> 32); }
+    static inline uint8_t mesh(uint64_t key) { return uint8_t(key); }
+
+private:
+    static constexpr uint32_t kDepthMax = (1u << 24) - 1;
+};
+
+// One draw, 32 bytes. The resources to bind are encoded in the key.
+struct RenderCommand {
+    uint64_t key;
+    float x;
+    float y;
+    float z;
+    float scaleX;
+    float scaleY;
+    uint32_t tint;
+};
+
+// Receives the deduplicated state changes and draws when a queue is executed
+class RenderBackend {
+public:
+    virtual ~RenderBackend() = default;
+    virtual void bindShader(uint8_t shader) = 0;
+    virtual void bindTexture(uint16_t texture) = 0;
+    virtual void bindMesh(uint8_t mesh) = 0;
+    virtual void draw(const RenderCommand &command) = 0;
+};
+
+struct RenderStats {
+    int draws = 0;
+    int shaderChanges = 0;
+    int textureChanges = 0;
+    int meshChanges = 0;
+
+    inline int stateChanges() const { return shaderChanges + textureChanges + meshChanges; }
+};
+
+/*!
+ * Frame's draw list, recorded off the GL thread.
+ *
+ * Each producer thread appends to its own Buffer, so recording needs no locks. The
+ * GL thread then merges the buffers, radix-sorts the merged commands by key and executes them,
+ * issuing a bind only when the shader, texture or mesh actually changes.
+ */
+class RenderQueue {
+public:
+    class Buffer {
+    public:
+        inline void push(const RenderCommand &command) { commands_.push_back(command); }
+
+        inline void draw(uint64_t key, float x, float y, float z, float scaleX = 1.0f, float scaleY = 1.0f,
+                         uint32_t tint = 0xFFFFFFFFu) {
+            commands_.push_back({key, x, y, z, scaleX, scaleY, tint});
+        }
+
+        inline int size() const { return (int) commands_.size(); }
+
+    private:
+        friend class RenderQueue;
+        std::vector<RenderCommand> commands_;
+    };
+
+    // Clears every buffer and makes sure there is one per producer
+    void beginFrame(int producers);
+
+    inline Buffer &getBuffer(int producer) { return buffers_[producer]; }
+
+    // Merges the producer buffers and sorts them by key (stable)
+    void sort();
+
+    /*!
+     * Issues the sorted commands, or the merged ones in recording order when sort() was not
+     * called since beginFrame().
+     */
+    RenderStats execute(RenderBackend &backend);
+
+    inline int getCommandCount() const { return (int) sorted_.size(); }
+
+private:
+    struct Entry {
+        uint64_t key;
+        uint32_t buffer;
+        uint32_t index;
+    };
+
+    void merge();
+
+    std::vector<Buffer> buffers_;
+    std::vector<Entry> sorted_;
+    std::vector<Entry> scratch_;
+    bool merged_ = false;
+};
+
+#endif //MAGEVOICE_RENDERQUEUE_H
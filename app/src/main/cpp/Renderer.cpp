@@ -3,20 +3,24 @@
 #include <EGL/egl.h>
 #include <GLES3/gl3.h>
 #include <android/native_window.h>
+#include <algorithm>
 #include <memory>
 #include <android/log.h>
+#include <android/trace.h>
 
 #include "AndroidOut.h"
 #include "Shader.h"
 #include "Utility.h"
 #include "Model.h"
+#include "Physics.h"
 #include "Vertex.h"
 
 #define LOG_TAG "MageVoiceNative"
 #define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
 #define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
 
-#define CORNFLOWER_BLUE 100 / 255.f, 149 / 255.f, 237 / 255.f, 1.0f
+// Outside the map, same grey as the rock outline
+#define ROCK_GREY 0x44 / 255.f, 0x44 / 255.f, 0x44 / 255.f, 1.0f
 
 // --- Shader Source --- 
 const std::string VERTEX_SHADER = R"shader(
@@ -60,22 +64,84 @@ const Vertex g_playerVertices[] = {
 
 const GLushort g_playerIndices[] = { 0, 1, 2, 0, 2, 3 };
 
+// Any value works as long as begin and end agree
+constexpr int32_t kResumeTraceCookie = 1;
+
+// Time constant of the camera easing toward the local player
+constexpr float kCameraSmoothingSeconds = 0.15f;
+// Frame times above this (a stall, a breakpoint) do not make the camera jump
+constexpr float kMaxFrameSeconds = 0.1f;
+
+// Half the edge of the player quad, for culling
+constexpr float kPlayerHalfSize = 0.5f;
+
+// Resource ids used in render keys
+constexpr uint8_t kLayerWorld = 0;
+constexpr uint8_t kShaderSprite = 0;
+constexpr uint16_t kTexturePlayer = 0;
+constexpr uint8_t kMeshPlayer = 0;
+
+// Issues the state changes and draws of a sorted RenderQueue with GL calls
+class GlRenderBackend : public RenderBackend {
+public:
+    GlRenderBackend(const Shader &shader, const Model *const *meshes, const GLuint *textures)
+            : shader_(shader), meshes_(meshes), textures_(textures) {}
+
+    ~GlRenderBackend() override {
+        if (mesh_) shader_.unbindMesh();
+    }
+
+    void bindShader(uint8_t) override { shader_.activate(); }
+
+    void bindTexture(uint16_t texture) override {
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, textures_[texture]);
+    }
+
+    void bindMesh(uint8_t mesh) override {
+        mesh_ = meshes_[mesh];
+        shader_.bindMesh(*mesh_);
+    }
+
+    void draw(const RenderCommand &command) override {
+        float modelMatrix[16] = {0};
+        Utility::buildTranslationMatrix(modelMatrix, command.x, command.y, command.z);
+        shader_.setModelMatrix(modelMatrix);
+        shader_.drawBoundMesh(*mesh_);
+    }
+
+private:
+    const Shader &shader_;
+    const Model *const *meshes_;
+    const GLuint *textures_;
+    const Model *mesh_ = nullptr;
+};
+
 
 Renderer::Renderer() :
     display_(EGL_NO_DISPLAY),
+    config_(nullptr),
     surface_(EGL_NO_SURFACE),
     context_(EGL_NO_CONTEXT),
     width_(0),
     height_(0),
-    shaderNeedsNewProjectionMatrix_(true) {
+    shaderNeedsNewProjectionMatrix_(true),
+    camera_(kProjectionHalfHeight, kCameraSmoothingSeconds),
+    tilemap_(Tilemap::makeArena(kArenaTiles, kArenaTiles, kArenaRockDensity, kArenaSeed)) {
     LOGI("Renderer constructor");
+    const float halfWidth = 0.5f * tilemap_.getWidth(), halfHeight = 0.5f * tilemap_.getHeight();
+    camera_.setWorldBounds({-halfWidth, -halfHeight, halfWidth, halfHeight});
+    // The player quad uses client side arrays; its texture is bound by id from the cache
+    playerModel_ = std::make_unique<Model>(g_playerVertices, 4, g_playerIndices, 6, nullptr);
+    playerTexture_ = resources_.addTexture(1, 1, {0xFFFFFFFFu});
+    tilemapRenderer_ = std::make_unique<TilemapRenderer>(tilemap_, resources_);
 }
 
 Renderer::~Renderer() {
     LOGI("Renderer destructor");
     if (display_ != EGL_NO_DISPLAY) {
-        eglMakeCurrent(display_, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
-        if (context_ != EGL_NO_CONTEXT) eglDestroyContext(display_, context_);
+        // Destroying the context frees every GL object, no need to make it current first
+        if (context_ != EGL_NO_CONTEXT) destroyContext(true);
         if (surface_ != EGL_NO_SURFACE) eglDestroySurface(display_, surface_);
         eglTerminate(display_);
     }
@@ -84,101 +150,233 @@ Renderer::~Renderer() {
     context_ = EGL_NO_CONTEXT;
 }
 
-void Renderer::init(ANativeWindow* window) {
-    LOGI("Renderer::init() start");
+bool Renderer::initDisplay() {
     const EGLint attribs[] = { EGL_RENDERABLE_TYPE, EGL_OPENGL_ES3_BIT, EGL_BLUE_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_RED_SIZE, 8, EGL_DEPTH_SIZE, 16, EGL_NONE };
-    EGLConfig config;
     EGLint numConfigs;
 
     LOGI("Calling eglGetDisplay");
     display_ = eglGetDisplay(EGL_DEFAULT_DISPLAY);
-    if (display_ == EGL_NO_DISPLAY) { LOGE("eglGetDisplay failed"); return; }
+    if (display_ == EGL_NO_DISPLAY) { LOGE("eglGetDisplay failed"); return false; }
 
     LOGI("Calling eglInitialize");
-    if (!eglInitialize(display_, nullptr, nullptr)) { LOGE("eglInitialize failed"); return; }
+    if (!eglInitialize(display_, nullptr, nullptr)) {
+        LOGE("eglInitialize failed");
+        display_ = EGL_NO_DISPLAY;
+        return false;
+    }
 
     LOGI("Calling eglChooseConfig");
-    if (!eglChooseConfig(display_, attribs, &config, 1, &numConfigs)) { LOGE("eglChooseConfig failed"); return; }
+    if (!eglChooseConfig(display_, attribs, &config_, 1, &numConfigs) || numConfigs < 1) {
+        LOGE("eglChooseConfig failed");
+        eglTerminate(display_);
+        display_ = EGL_NO_DISPLAY;
+        return false;
+    }
+    return true;
+}
 
+bool Renderer::createContext() {
     LOGI("Calling eglCreateContext");
     const EGLint context_attribs[] = { EGL_CONTEXT_CLIENT_VERSION, 3, EGL_NONE };
-    context_ = eglCreateContext(display_, config, nullptr, context_attribs);
-    if (context_ == EGL_NO_CONTEXT) { LOGE("eglCreateContext failed"); return; }
-
-    LOGI("Calling eglCreateWindowSurface");
-    surface_ = eglCreateWindowSurface(display_, config, window, nullptr);
-    if (surface_ == EGL_NO_SURFACE) { LOGE("eglCreateWindowSurface failed"); return; }
-
-    LOGI("Calling eglMakeCurrent");
-    if (!eglMakeCurrent(display_, surface_, surface_, context_)) { LOGE("eglMakeCurrent failed"); return; }
-
-    LOGI("Calling eglQuerySurface");
-    eglQuerySurface(display_, surface_, EGL_WIDTH, &width_);
-    eglQuerySurface(display_, surface_, EGL_HEIGHT, &height_);
+    context_ = eglCreateContext(display_, config_, nullptr, context_attribs);
+    if (context_ == EGL_NO_CONTEXT) { LOGE("eglCreateContext failed"); return false; }
+    return true;
+}
 
+void Renderer::createGpuResources() {
     LOGI("Loading shader");
     shader_.reset(Shader::loadShader(VERTEX_SHADER, FRAGMENT_SHADER, "aPosition", "aUV", "uProjectionMatrix", "uModelMatrix"));
     if (!shader_) { LOGE("Shader::loadShader failed"); return; }
 
-    LOGI("Creating dummy texture");
-    GLuint dummyTextureId;
-    glGenTextures(1, &dummyTextureId);
-    glBindTexture(GL_TEXTURE_2D, dummyTextureId);
-    GLubyte whitePixel[] = {255, 255, 255, 255};
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, whitePixel);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    auto dummyTexture = std::make_shared<TextureAsset>(dummyTextureId);
-
-    LOGI("Creating player model");
-    // This is the mesh and texture for a player, it will be reused for all players.
-    playerModel_ = std::make_unique<Model>(g_playerVertices, 4, g_playerIndices, 6, dummyTexture);
+    LOGI("Uploading %zu bytes of cached textures", resources_.getCpuBytes());
+    resources_.restore();
 
     glEnable(GL_DEPTH_TEST);
-    glClearColor(CORNFLOWER_BLUE);
+    glClearColor(ROCK_GREY);
     shader_->activate();
-    LOGI("Renderer::init() finished");
+    shaderNeedsNewProjectionMatrix_ = true;
+    // The new program has no matrices yet
+    uploadedCameraRevision_ = 0;
+}
+
+void Renderer::releaseGpuResources(bool contextLost) {
+    // Chunk buffers are baked again from the tilemap as chunks come into view
+    tilemapRenderer_->releaseGpu(contextLost);
+    resources_.release(contextLost);
+    if (shader_ && contextLost) shader_->abandon();
+    shader_.reset();
+}
+
+void Renderer::destroyContext(bool contextLost) {
+    releaseGpuResources(contextLost);
+    eglMakeCurrent(display_, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    eglDestroyContext(display_, context_);
+    context_ = EGL_NO_CONTEXT;
+}
+
+bool Renderer::recoverLostContext() {
+    LOGI("EGL context lost, restoring GPU resources from the cache");
+    destroyContext(true);
+    if (!createContext()) return false;
+    if (!eglMakeCurrent(display_, surface_, surface_, context_)) { LOGE("eglMakeCurrent failed"); return false; }
+    createGpuResources();
+    resumeKind_ = ResumeKind::ContextRestored;
+    return true;
+}
+
+bool Renderer::attachWindow(ANativeWindow* window) {
+    LOGI("Renderer::attachWindow() start");
+    ATrace_beginSection("Renderer::attachWindow");
+    bool coldStart = false;
+    if (display_ == EGL_NO_DISPLAY) {
+        if (!initDisplay()) { ATrace_endSection(); return false; }
+        coldStart = true;
+    }
+
+    bool newContext = false;
+    if (context_ == EGL_NO_CONTEXT) {
+        if (!createContext()) { ATrace_endSection(); return false; }
+        newContext = true;
+    }
+
+    LOGI("Calling eglCreateWindowSurface");
+    surface_ = eglCreateWindowSurface(display_, config_, window, nullptr);
+    if (surface_ == EGL_NO_SURFACE) { LOGE("eglCreateWindowSurface failed"); ATrace_endSection(); return false; }
+
+    LOGI("Calling eglMakeCurrent");
+    bool current = eglMakeCurrent(display_, surface_, surface_, context_);
+    if (!current && eglGetError() == EGL_CONTEXT_LOST) {
+        // Lost while the app was in the background
+        current = recoverLostContext();
+    } else if (current && newContext) {
+        createGpuResources();
+        resumeKind_ = coldStart ? ResumeKind::ColdStart : ResumeKind::ContextRestored;
+    } else if (current) {
+        resumeKind_ = ResumeKind::SurfaceOnly;
+    }
+    if (!current) {
+        LOGE("eglMakeCurrent failed");
+        eglDestroySurface(display_, surface_);
+        surface_ = EGL_NO_SURFACE;
+        ATrace_endSection();
+        return false;
+    }
+
+    // Forces updateRenderArea to set the viewport for the new surface
+    width_ = 0;
+    height_ = 0;
+    ATrace_endSection();
+    LOGI("Renderer::attachWindow() finished");
+    return true;
+}
+
+void Renderer::detachWindow() {
+    LOGI("Renderer::detachWindow()");
+    if (display_ == EGL_NO_DISPLAY) return;
+    eglMakeCurrent(display_, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    if (surface_ != EGL_NO_SURFACE) eglDestroySurface(display_, surface_);
+    surface_ = EGL_NO_SURFACE;
+}
+
+void Renderer::beginResume() {
+    // Spans threads (JNI to render thread), so it is an async section in systrace/Perfetto
+    if (!resumePending_) ATrace_beginAsyncSection("resume to first frame", kResumeTraceCookie);
+    resumeStart_ = std::chrono::steady_clock::now();
+    resumePending_ = true;
+}
+
+void Renderer::setLocalPlayer(const std::string& id) {
+    localPlayerId_ = id;
+    cameraPlaced_ = false;
 }
 
 // Update logic now iterates through all players
 void Renderer::update(Model& model) {
     const float speed = 0.1f;
-    float aspect = float(width_) / height_;
-    float worldHalfWidth = kProjectionHalfHeight * aspect;
-    float worldHalfHeight = kProjectionHalfHeight;
+    const ObstacleGrid& obstacles = tilemap_.getObstacles();
 
     for (auto& pair : model.players) {
         PlayerState& player = pair.second;
-        player.position.x += player.velocity.x * speed;
-        player.position.y -= player.velocity.y * speed;
+        // Rocks and the map edge stop the player; it slides along them
+        obstacles.slide(player.position.x, player.position.y, player.velocity.x * speed,
+                        -player.velocity.y * speed, Physics::kPlayerRadius);
+    }
 
-        // World boundaries check
-        if (player.position.x > worldHalfWidth) player.position.x = worldHalfWidth;
-        if (player.position.x < -worldHalfWidth) player.position.x = -worldHalfWidth;
-        if (player.position.y > worldHalfHeight) player.position.y = worldHalfHeight;
-        if (player.position.y < -worldHalfHeight) player.position.y = -worldHalfHeight;
+    const auto now = std::chrono::steady_clock::now();
+    const float dt = std::min(kMaxFrameSeconds, std::chrono::duration<float>(now - lastUpdate_).count());
+    lastUpdate_ = now;
+    auto local = model.players.find(localPlayerId_);
+    if (local != model.players.end()) {
+        const Vector2& position = local->second.position;
+        if (cameraPlaced_) {
+            camera_.follow(position.x, position.y, dt);
+        } else {
+            // First frame with the player: no easing in from the map centre
+            camera_.snapTo(position.x, position.y);
+            cameraPlaced_ = true;
+        }
     }
 }
 
 // Render logic now iterates through all players
 void Renderer::render(const Model& model) {
-    if (display_ == EGL_NO_DISPLAY || !shader_) return;
+    if (surface_ == EGL_NO_SURFACE || !shader_) return;
 
     updateRenderArea();
+    updateViewProjection();
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
+    const ViewRect view = camera_.getVisibleRect();
+    if (tilemapRenderer_) {
+        tilemapRenderer_->draw(*shader_, view.left, view.bottom, view.right, view.top);
+    }
+
     if (playerModel_) {
+        // Cull against the view first, so only visible players are recorded and sorted
+        playerX_.clear();
+        playerY_.clear();
         for (const auto& pair : model.players) {
-            const PlayerState& player = pair.second;
-            float playerModelMatrix[16] = {0};
-            Utility::buildTranslationMatrix(playerModelMatrix, player.position.x, player.position.y, 0.0f);
-            shader_->setModelMatrix(playerModelMatrix);
-            shader_->drawModel(*playerModel_);
+            playerX_.push_back(pair.second.position.x);
+            playerY_.push_back(pair.second.position.y);
+        }
+        visiblePlayers_.resize(playerX_.size());
+        const int visible = camera_.cull(playerX_.data(), playerY_.data(), int(playerX_.size()), kPlayerHalfSize,
+                                         visiblePlayers_.data());
+
+        // Single producer for now; simulation workers can record into their own buffers
+        renderQueue_.beginFrame(1);
+        RenderQueue::Buffer& buffer = renderQueue_.getBuffer(0);
+        for (int i = 0; i < visible; i++) {
+            const float x = playerX_[visiblePlayers_[i]];
+            const float y = playerY_[visiblePlayers_[i]];
+            float depth = (y - view.bottom) / (view.top - view.bottom);
+            uint64_t key = RenderKey::make(kLayerWorld, kShaderSprite, kTexturePlayer, depth, kMeshPlayer);
+            buffer.draw(key, x, y, 0.0f);
         }
+        renderQueue_.sort();
+
+        const Model* meshes[] = { playerModel_.get() };
+        const GLuint textures[] = { resources_.getTexture(playerTexture_) };
+        GlRenderBackend backend(*shader_, meshes, textures);
+        renderQueue_.execute(backend);
     }
 
     if (eglSwapBuffers(display_, surface_) != EGL_TRUE) {
-        LOGE("eglSwapBuffers failed!");
+        if (eglGetError() == EGL_CONTEXT_LOST) {
+            recoverLostContext();
+        } else {
+            LOGE("eglSwapBuffers failed!");
+        }
+        return;
+    }
+
+    if (resumePending_) {
+        ATrace_endAsyncSection("resume to first frame", kResumeTraceCookie);
+        resumePending_ = false;
+        lastResumeKind_ = resumeKind_;
+        lastResumeMs_ = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - resumeStart_).count();
+        static const char* kResumeKindNames[] = { "cold start", "surface only", "context restored" };
+        LOGI("Resume to first frame: %.1f ms (%s)", lastResumeMs_, kResumeKindNames[int(lastResumeKind_)]);
     }
 }
 
@@ -193,6 +391,25 @@ void Renderer::updateRenderArea() {
         width_ = currentWidth;
         height_ = currentHeight;
         glViewport(0, 0, width_, height_);
+        camera_.setViewport(width_, height_);
         shaderNeedsNewProjectionMatrix_ = true;
     }
 }
+
+void Renderer::updateViewProjection() {
+    if (!shaderNeedsNewProjectionMatrix_ && camera_.getRevision() == uploadedCameraRevision_) return;
+
+    if (shaderNeedsNewProjectionMatrix_) {
+        Utility::buildOrthographicMatrix(projectionMatrix_, kProjectionHalfHeight, camera_.getAspect(),
+                                         kProjectionNearPlane, kProjectionFarPlane);
+        shaderNeedsNewProjectionMatrix_ = false;
+    }
+    float viewMatrix[16];
+    Utility::buildTranslationMatrix(viewMatrix, -camera_.getCenterX(), -camera_.getCenterY(), 0.0f);
+    float viewProjection[16];
+    Utility::multiplyMatrices(viewProjection, projectionMatrix_, viewMatrix);
+
+    shader_->activate();
+    shader_->setProjectionMatrix(viewProjection);
+    uploadedCameraRevision_ = camera_.getRevision();
+}
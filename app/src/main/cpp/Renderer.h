@@ -2,21 +2,63 @@
 #define MAGEVOICE_RENDERER_H
 
 #include <EGL/egl.h>
+#include <chrono>
 #include <memory>
+#include <string>
+#include <vector>
 
+#include "Camera.h"
 #include "GameState.h"
 class Model; // Forward declaration for the drawable model
+#include "GpuResourceCache.h"
+#include "RenderQueue.h"
 #include "Shader.h"
+#include "Tilemap.h"
+#include "TilemapRenderer.h"
 
 struct ANativeWindow;
 
+// What a resume had to rebuild before its first frame
+enum class ResumeKind {
+    ColdStart,       // EGL display, context and every GPU resource
+    SurfaceOnly,     // Only the window surface; the context survived
+    ContextRestored  // The context was lost; GPU resources came back from the cache
+};
+
+/*!
+ * Draws the game into an Android window.
+ *
+ * The EGL display, context and GPU resources outlive the window: attachWindow() and
+ * detachWindow() only create and destroy the window surface, so an app switch or a rotation
+ * does not recompile shaders or regenerate textures. Everything GPU side can be rebuilt from
+ * CPU copies (the resource cache, the tilemap, the shader sources) for when the context is lost.
+ * All methods but the constructor, destructor and beginResume() run on the render thread.
+ */
 class Renderer {
 public:
+    // Builds the CPU side resources; no EGL or GL calls
     Renderer();
     virtual ~Renderer();
 
-    // Initialize the renderer with a native window
-    void init(ANativeWindow* window);
+    /*!
+     * Binds the window to the calling thread. The first call creates the display and context;
+     * later ones only create a window surface unless the context was lost meanwhile.
+     * @return false if EGL failed, the renderer then stays detached
+     */
+    bool attachWindow(ANativeWindow* window);
+
+    // Destroys the window surface and unbinds the context from the calling thread
+    void detachWindow();
+
+    // Starts timing a resume; the first frame swapped after it logs the resume-to-frame time
+    void beginResume();
+
+    inline double getLastResumeMs() const { return lastResumeMs_; }
+
+    inline ResumeKind getLastResumeKind() const { return lastResumeKind_; }
+
+    // Player the camera follows
+    void setLocalPlayer(const std::string& id);
 
     // Update the game state
     void update(Model& model);
@@ -28,19 +70,58 @@ public:
     void handleInput();
 
 private:
-    void initRenderer();
+    bool initDisplay();
+    bool createContext();
+    // Shader and GPU copies of the cached resources, on a freshly current context
+    void createGpuResources();
+    void releaseGpuResources(bool contextLost);
+    void destroyContext(bool contextLost);
+    // Replaces a lost context and restores the GPU resources; surface_ must be valid
+    bool recoverLostContext();
     void updateRenderArea();
+    // Uploads projection * view when the viewport or the camera changed since the last upload
+    void updateViewProjection();
 
     EGLDisplay display_;
+    EGLConfig config_;
     EGLSurface surface_;
     EGLContext context_;
     EGLint width_;
     EGLint height_;
 
     bool shaderNeedsNewProjectionMatrix_;
+    float projectionMatrix_[16];
+
+    // Follows the local player over the tilemap; its revision tells when the view moved
+    Camera camera_;
+    uint32_t uploadedCameraRevision_ = 0;
+    std::string localPlayerId_;
+    std::chrono::steady_clock::time_point lastUpdate_;
+    bool cameraPlaced_ = false;
 
     std::unique_ptr<Shader> shader_;
     std::unique_ptr<Model> playerModel_;
+
+    GpuResourceCache resources_;
+    GpuResourceCache::TextureId playerTexture_;
+
+    // Static level, the same arena the server simulates; its obstacle grid bounds player movement
+    Tilemap tilemap_;
+    std::unique_ptr<TilemapRenderer> tilemapRenderer_;
+
+    // Draw list for the frame; render() records into it and executes it sorted
+    RenderQueue renderQueue_;
+    // Player positions gathered for culling, and the indices of the visible ones
+    std::vector<float> playerX_;
+    std::vector<float> playerY_;
+    std::vector<uint32_t> visiblePlayers_;
+
+    // Resume instrumentation
+    std::chrono::steady_clock::time_point resumeStart_;
+    bool resumePending_ = false;
+    ResumeKind resumeKind_ = ResumeKind::ColdStart;
+    ResumeKind lastResumeKind_ = ResumeKind::ColdStart;
+    double lastResumeMs_ = 0.0;
 };
 
 #endif //MAGEVOICE_RENDERER_H
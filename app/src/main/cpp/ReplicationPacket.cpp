@@ -0,0 +1,52 @@
+#include "ReplicationPacket.h"
+
+#include <algorithm>
+
+#include "WireFormat.h"
+
+constexpr size_t kEventCountOffset = 4;
+constexpr size_t kEntityCountOffset = 5;
+
+void ReplicationPacket::begin(std::vector<uint8_t> &packet, uint32_t tick) {
+    packet.clear();
+    WireFormat::put32(packet, tick);
+    packet.push_back(0);
+    packet.push_back(0);
+}
+
+void ReplicationPacket::writeEvent(std::vector<uint8_t> &packet, const SpellEvent &event) {
+    packet[kEventCountOffset]++;
+    packet.push_back(static_cast<uint8_t>(event.spell));
+    WireFormat::put16(packet, uint16_t(event.caster));
+    WireFormat::putPosition(packet, event.x);
+    WireFormat::putPosition(packet, event.y);
+}
+
+void ReplicationPacket::writeEntity(std::vector<uint8_t> &packet, const World &world, EntityId id) {
+    packet[kEntityCountOffset]++;
+    WireFormat::put16(packet, uint16_t(id));
+    WireFormat::putPosition(packet, world.posX[id]);
+    WireFormat::putPosition(packet, world.posY[id]);
+    packet.push_back(uint8_t(std::clamp(world.hp[id], 0, 255)));
+    packet.push_back(uint8_t(std::clamp(world.mana[id], 0, 255)));
+}
+
+bool ReplicationPacket::read(const uint8_t *data, size_t size, uint32_t &outTick,
+                             std::vector<SpellEvent> &outEvents, std::vector<EntitySnapshot> &outEntities) {
+    outEvents.clear();
+    outEntities.clear();
+    if (size < kHeaderBytes) return false;
+    outTick = WireFormat::get32(data);
+    int events = data[kEventCountOffset];
+    int entities = data[kEntityCountOffset];
+    if (size < size_t(kHeaderBytes + events * kEventBytes + entities * kEntityBytes)) return false;
+
+    const uint8_t *p = data + kHeaderBytes;
+    for (int i = 0; i < events; i++, p += kEventBytes) {
+        outEvents.push_back({WireFormat::get16(p + 1), static_cast<SpellType>(p[0]), WireFormat::getPosition(p + 3), WireFormat::getPosition(p + 5), outTick});
+    }
+    for (int i = 0; i < entities; i++, p += kEntityBytes) {
+        outEntities.push_back({WireFormat::get16(p), WireFormat::getPosition(p + 2), WireFormat::getPosition(p + 4), p[6], p[7]});
+    }
+    return true;
+}
@@ -0,0 +1,60 @@
+#ifndef MAGEVOICE_REPLICATIONPACKET_H
+#define MAGEVOICE_REPLICATIONPACKET_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "SpellType.h"
+#include "WireFormat.h"
+#include "World.h"
+
+// Spell cast that clients should see, e.g. to play the cast animation
+struct SpellEvent {
+    EntityId caster;
+    SpellType spell;
+    float x;
+    float y;
+    uint32_t tick;
+};
+
+// One replicated entity as decoded by a client
+struct EntitySnapshot {
+    EntityId id;
+    float x;
+    float y;
+    int hp;
+    int mana;
+};
+
+/*!
+ * Binary state update sent to one client per tick, replacing the JSON of SyncJsonUtil.
+ *
+ * Layout (little endian): tick u32, event count u8, entity count u8, then the events
+ * (spell u8, caster u16, x i16, y i16) and the entities (id u16, x i16, y i16, hp u8, mana u8).
+ * Positions are fixed point with kPositionScale steps per world unit.
+ */
+class ReplicationPacket {
+public:
+    static constexpr int kHeaderBytes = 6;
+    static constexpr int kEventBytes = 7;
+    static constexpr int kEntityBytes = 8;
+    static constexpr float kPositionScale = WireFormat::kPositionScale;
+    static constexpr int kMaxRecords = 255;
+
+    static void begin(std::vector<uint8_t> &packet, uint32_t tick);
+
+    // Events must all be written before the first entity
+    static void writeEvent(std::vector<uint8_t> &packet, const SpellEvent &event);
+
+    static void writeEntity(std::vector<uint8_t> &packet, const World &world, EntityId id);
+
+    /*!
+     * Decodes a packet produced by the writers above.
+     * @return false if the packet is truncated
+     */
+    static bool read(const uint8_t *data, size_t size, uint32_t &outTick,
+                     std::vector<SpellEvent> &outEvents, std::vector<EntitySnapshot> &outEntities);
+};
+
+#endif //MAGEVOICE_REPLICATIONPACKET_H
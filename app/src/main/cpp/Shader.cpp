@@ -109,17 +109,43 @@ void Shader::deactivate() const {
 }
 
 void Shader::drawModel(const Model &model) const {
+    bindMesh(model);
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, model.getTexture().getTextureID());
+
+    drawBoundMesh(model);
+    unbindMesh();
+}
+
+void Shader::bindMesh(const Model &model) const {
     glVertexAttribPointer(position_, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), model.getVertexData());
     glEnableVertexAttribArray(position_);
 
     glVertexAttribPointer(uv_, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), ((uint8_t *) model.getVertexData()) + sizeof(Vector3));
     glEnableVertexAttribArray(uv_);
+}
 
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, model.getTexture().getTextureID());
-
+void Shader::drawBoundMesh(const Model &model) const {
     glDrawElements(GL_TRIANGLES, model.getIndexCount(), GL_UNSIGNED_SHORT, model.getIndexData());
+}
+
+void Shader::bindBufferedMesh(GLuint vertexBuffer, GLuint indexBuffer) const {
+    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+
+    glVertexAttribPointer(position_, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), nullptr);
+    glEnableVertexAttribArray(position_);
+
+    glVertexAttribPointer(uv_, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (const void *) sizeof(Vector3));
+    glEnableVertexAttribArray(uv_);
+}
+
+void Shader::drawBufferedMesh(GLsizei indexCount) const {
+    glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_SHORT, nullptr);
+}
 
+void Shader::unbindMesh() const {
     glDisableVertexAttribArray(uv_);
     glDisableVertexAttribArray(position_);
 }
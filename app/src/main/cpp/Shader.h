@@ -23,10 +23,22 @@ public:
         }
     }
 
+    // The context died and took the program with it: forget it without calling GL
+    inline void abandon() { program_ = 0; }
+
     void activate() const;
     void deactivate() const;
     void drawModel(const Model &model) const;
 
+    // Split drawModel for sorted command lists: bind the mesh once, draw it many times
+    void bindMesh(const Model &model) const;
+    void drawBoundMesh(const Model &model) const;
+    void unbindMesh() const;
+
+    // Static geometry in GL buffers, laid out as Vertex and GLushort indices
+    void bindBufferedMesh(GLuint vertexBuffer, GLuint indexBuffer) const;
+    void drawBufferedMesh(GLsizei indexCount) const;
+
     void setProjectionMatrix(float *projectionMatrix) const;
     void setModelMatrix(float *modelMatrix) const; // Added model matrix setter
 
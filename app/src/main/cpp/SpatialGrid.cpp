@@ -0,0 +1,55 @@
+#include "SpatialGrid.h"
+
+#include <algorithm>
+#include <cmath>
+
+// Keeps the cell table bounded when a few points are far away from the rest
+constexpr int kMaxCellsPerAxis = 1024;
+
+void SpatialGrid::build(const float *x, const float *y, int count, float cellSize) {
+    entries_.resize(count);
+    sortedX_.resize(count);
+    sortedY_.resize(count);
+    cellOf_.resize(count);
+    if (count == 0) {
+        columns_ = rows_ = 0;
+        cellStart_.assign(1, 0);
+        return;
+    }
+
+    float minX = x[0], maxX = x[0], minY = y[0], maxY = y[0];
+    for (int i = 1; i < count; i++) {
+        minX = std::min(minX, x[i]);
+        maxX = std::max(maxX, x[i]);
+        minY = std::min(minY, y[i]);
+        maxY = std::max(maxY, y[i]);
+    }
+    float extent = std::max(maxX - minX, maxY - minY);
+    cellSize = std::max(cellSize, extent / (kMaxCellsPerAxis - 1));
+    if (cellSize <= 0.0f) cellSize = 1.0f;
+
+    originX_ = minX;
+    originY_ = minY;
+    inverseCellSize_ = 1.0f / cellSize;
+    columns_ = std::min(kMaxCellsPerAxis, int((maxX - minX) * inverseCellSize_) + 1);
+    rows_ = std::min(kMaxCellsPerAxis, int((maxY - minY) * inverseCellSize_) + 1);
+
+    // Counting sort: histogram, exclusive prefix sum, scatter
+    cellStart_.assign(columns_ * rows_ + 1, 0);
+    for (int i = 0; i < count; i++) {
+        uint32_t cell = uint32_t(cellY(y[i]) * columns_ + cellX(x[i]));
+        cellOf_[i] = cell;
+        cellStart_[cell + 1]++;
+    }
+    for (size_t c = 1; c < cellStart_.size(); c++) {
+        cellStart_[c] += cellStart_[c - 1];
+    }
+    std::vector<uint32_t> &cursor = scratch_;
+    cursor.assign(cellStart_.begin(), cellStart_.end() - 1);
+    for (int i = 0; i < count; i++) {
+        uint32_t slot = cursor[cellOf_[i]]++;
+        entries_[slot] = uint32_t(i);
+        sortedX_[slot] = x[i];
+        sortedY_[slot] = y[i];
+    }
+}
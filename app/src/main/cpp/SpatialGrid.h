@@ -0,0 +1,76 @@
+#ifndef MAGEVOICE_SPATIALGRID_H
+#define MAGEVOICE_SPATIALGRID_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*!
+ * Uniform grid over a set of points, rebuilt from scratch each tick.
+ *
+ * build() counting-sorts the point indices (and a copy of their coordinates) by cell, so every
+ * cell is a contiguous slice of getEntries() and a query only touches the cells overlapping it.
+ */
+class SpatialGrid {
+public:
+    /*!
+     * @param x, y point coordinates, count elements each
+     * @param cellSize edge of a square cell; use the largest query radius for best results
+     */
+    void build(const float *x, const float *y, int count, float cellSize);
+
+    /*!
+     * Calls visit(index, x, y) for every point in the cells overlapping the circle. Points outside
+     * the circle but inside those cells are visited too, callers test the exact distance. The
+     * coordinates come from the grid's cell-ordered copy, so neighbours are read contiguously.
+     */
+    template<typename Visitor>
+    void queryCircle(float cx, float cy, float radius, Visitor &&visit) const {
+        if (entries_.empty()) return;
+        int x0 = cellX(cx - radius), x1 = cellX(cx + radius);
+        int y0 = cellY(cy - radius), y1 = cellY(cy + radius);
+        for (int gy = y0; gy <= y1; gy++) {
+            const uint32_t *row = cellStart_.data() + gy * columns_;
+            for (int gx = x0; gx <= x1; gx++) {
+                for (uint32_t i = row[gx]; i < row[gx + 1]; i++) {
+                    visit(entries_[i], sortedX_[i], sortedY_[i]);
+                }
+            }
+        }
+    }
+
+    // Point indices in cell order; iterating in this order keeps neighbouring queries cache friendly
+    inline const std::vector<uint32_t> &getEntries() const { return entries_; }
+
+    // Heap bytes held by the cell table, the sorted copies and the build scratch
+    inline size_t getByteSize() const {
+        return (cellStart_.capacity() + entries_.capacity() + cellOf_.capacity() + scratch_.capacity()) *
+               sizeof(uint32_t) + (sortedX_.capacity() + sortedY_.capacity()) * sizeof(float);
+    }
+
+private:
+    inline int cellX(float x) const {
+        int c = int((x - originX_) * inverseCellSize_);
+        return c < 0 ? 0 : (c >= columns_ ? columns_ - 1 : c);
+    }
+
+    inline int cellY(float y) const {
+        int c = int((y - originY_) * inverseCellSize_);
+        return c < 0 ? 0 : (c >= rows_ ? rows_ - 1 : c);
+    }
+
+    float originX_ = 0.0f;
+    float originY_ = 0.0f;
+    float inverseCellSize_ = 1.0f;
+    int columns_ = 0;
+    int rows_ = 0;
+    // Cell c (row-major) holds entries_[cellStart_[c] .. cellStart_[c + 1])
+    std::vector<uint32_t> cellStart_;
+    std::vector<uint32_t> entries_;
+    std::vector<float> sortedX_;
+    std::vector<float> sortedY_;
+    std::vector<uint32_t> cellOf_;
+    std::vector<uint32_t> scratch_;
+};
+
+#endif //MAGEVOICE_SPATIALGRID_H
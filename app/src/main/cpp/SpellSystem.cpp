@@ -0,0 +1,194 @@
+#include "SpellSystem.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "Physics.h"
+
+SpellSystem::SpellSystem(const SpellTable &table) : table_(table) {}
+
+void SpellSystem::setHistory(const PositionHistory *history, uint32_t maxRewindTicks) {
+    history_ = history;
+    maxRewindTicks_ = maxRewindTicks;
+}
+
+uint32_t SpellSystem::hitTestTick(const CastRequest &cast, uint32_t tick) const {
+    if (!history_ || history_->isEmpty() || cast.viewTick == 0 || cast.viewTick >= tick) return tick;
+    const uint32_t limit = tick - std::min(tick, maxRewindTicks_);
+    // A view older than the window is tested at the window's edge
+    const uint32_t rewound = history_->clampTick(std::max(cast.viewTick, limit));
+    return rewound >= limit && rewound < tick ? rewound : tick;
+}
+
+void SpellSystem::clampToRange(const World &world, CastRequest &cast) const {
+    if (cast.caster >= (EntityId) world.size() || cast.spell >= SpellType::Count) return;
+    const uint32_t hitTick = hitTestTick(cast, world.tick);
+    float x = world.posX[cast.caster], y = world.posY[cast.caster];
+    if (hitTick != world.tick && (int) cast.caster < history_->getEntityCount(hitTick) &&
+        history_->wasAlive(hitTick, cast.caster)) {
+        x = history_->getX(hitTick, cast.caster);
+        y = history_->getY(hitTick, cast.caster);
+    }
+    const float range = table_.get(cast.spell).range;
+    const float dx = cast.targetX - x, dy = cast.targetY - y;
+    const float distSq = dx * dx + dy * dy;
+    if (distSq <= range * range) return;
+    const float scale = range / std::sqrt(distSq);
+    cast.targetX = x + dx * scale;
+    cast.targetY = y + dy * scale;
+}
+
+void SpellSystem::resolve(World &world, std::vector<CastResult> *outResults, float halfExtent) {
+    resolveCasts(world, outResults, nullptr, halfExtent);
+}
+
+void SpellSystem::resolve(World &world, const ObstacleGrid &obstacles, std::vector<CastResult> *outResults) {
+    resolveCasts(world, outResults, &obstacles, 0.0f);
+}
+
+void SpellSystem::resolveCasts(World &world, std::vector<CastResult> *outResults, const ObstacleGrid *obstacles,
+                               float halfExtent) {
+    if (outResults) outResults->clear();
+    if (pending_.empty()) return;
+
+    const int entities = world.size();
+    const uint32_t tick = world.tick;
+    if ((int) isTouched_.size() < entities) {
+        readyTick_.resize(size_t(entities) * kSpellTypeCount, 0);
+        damage_.resize(entities, 0);
+        pushX_.resize(entities, 0.0f);
+        pushY_.resize(entities, 0.0f);
+        isTouched_.resize(entities, 0);
+    }
+
+    // Validation in arrival order: a second cast of the same spell in a tick hits the cooldown
+    accepted_.clear();
+    acceptedResult_.clear();
+    for (const CastRequest &cast : pending_) {
+        CastStatus status = CastStatus::Cast;
+        if (cast.caster >= (EntityId) entities || cast.spell >= SpellType::Count || !world.alive[cast.caster]) {
+            status = CastStatus::InvalidCaster;
+        } else {
+            const SpellDefinition &def = table_.get(cast.spell);
+            uint32_t &ready = readyTick_[size_t(cast.caster) * kSpellTypeCount + static_cast<int>(cast.spell)];
+            if (tick < ready) {
+                status = CastStatus::OnCooldown;
+            } else if (world.mana[cast.caster] < def.manaCost) {
+                status = CastStatus::NoMana;
+            } else {
+                world.mana[cast.caster] -= def.manaCost;
+                ready = tick + def.cooldownTicks;
+                accepted_.push_back(cast);
+                acceptedResult_.push_back(outResults ? (int) outResults->size() : -1);
+            }
+        }
+        if (outResults) outResults->push_back({cast.caster, cast.spell, status, 0});
+    }
+    pending_.clear();
+    if (accepted_.empty()) return;
+
+    grid_.build(world.posX.data(), world.posY.data(), entities, std::max(table_.getMaxRadius(), 1.0f));
+
+    for (size_t c = 0; c < accepted_.size(); c++) {
+        const CastRequest &cast = accepted_[c];
+        const SpellDefinition &def = table_.get(cast.spell);
+        uint16_t hits = 0;
+
+        if (def.shape == SpellShape::Self) {
+            applyHit(world, def, cast, cast.caster);
+            hits = 1;
+        } else {
+            const float radiusSq = def.radius * def.radius;
+            EntityId nearest = 0;
+            float nearestSq = std::numeric_limits<float>::max();
+            auto visit = [&](uint32_t e, float x, float y) {
+                if (e == cast.caster || !world.alive[e]) return;
+                float dx = x - cast.targetX;
+                float dy = y - cast.targetY;
+                float distSq = dx * dx + dy * dy;
+                if (distSq > radiusSq) return;
+                if (def.shape == SpellShape::Area) {
+                    applyHit(world, def, cast, e);
+                    hits++;
+                } else if (distSq < nearestSq) {
+                    nearestSq = distSq;
+                    nearest = e;
+                }
+            };
+            const uint32_t hitTick = hitTestTick(cast, tick);
+            if (hitTick == tick) {
+                grid_.queryCircle(cast.targetX, cast.targetY, def.radius, visit);
+            } else {
+                // Entities alive both then and now, at the position they had then
+                history_->queryCircle(hitTick, cast.targetX, cast.targetY, def.radius, visit);
+            }
+            if (def.shape == SpellShape::Nearest && nearestSq <= radiusSq) {
+                applyHit(world, def, cast, nearest);
+                hits = 1;
+            }
+        }
+
+        if (outResults && acceptedResult_[c] >= 0) (*outResults)[acceptedResult_[c]].hits = hits;
+    }
+
+    // Apply accumulated damage (shields absorb first) and knockback
+    for (EntityId e : touched_) {
+        int damage = damage_[e];
+        if (damage > 0 && tick < world.shieldUntil[e]) {
+            int absorbed = std::min(damage, world.shieldHp[e]);
+            world.shieldHp[e] -= absorbed;
+            damage -= absorbed;
+        }
+        if (damage > 0) {
+            world.hp[e] = std::max(0, world.hp[e] - damage);
+            if (world.hp[e] == 0) world.alive[e] = 0;
+        }
+        if (obstacles) {
+            obstacles->slide(world.posX[e], world.posY[e], pushX_[e], pushY_[e], Physics::kPlayerRadius);
+        } else {
+            world.posX[e] = std::clamp(world.posX[e] + pushX_[e], -halfExtent, halfExtent);
+            world.posY[e] = std::clamp(world.posY[e] + pushY_[e], -halfExtent, halfExtent);
+        }
+
+        damage_[e] = 0;
+        pushX_[e] = pushY_[e] = 0.0f;
+        isTouched_[e] = 0;
+    }
+    touched_.clear();
+}
+
+void SpellSystem::applyHit(World &world, const SpellDefinition &def, const CastRequest &cast, EntityId target) {
+    if (!isTouched_[target]) {
+        isTouched_[target] = 1;
+        touched_.push_back(target);
+    }
+    damage_[target] += def.damage;
+
+    switch (def.effect) {
+        case SpellEffect::Slow: {
+            // Overlapping slows keep the strongest; an expired one leaves nothing to keep
+            const float potency = std::clamp(def.magnitude, 0.0f, 1.0f);
+            const bool slowed = world.tick < world.slowUntil[target];
+            world.slowPotency[target] = slowed ? std::max(world.slowPotency[target], potency) : potency;
+            world.slowUntil[target] = std::max(world.slowUntil[target], world.tick + def.effectTicks);
+            break;
+        }
+        case SpellEffect::Knockback: {
+            float dx = world.posX[target] - cast.targetX;
+            float dy = world.posY[target] - cast.targetY;
+            float length = std::sqrt(dx * dx + dy * dy);
+            if (length > 0.0f) {
+                pushX_[target] += dx / length * def.magnitude;
+                pushY_[target] += dy / length * def.magnitude;
+            }
+            break;
+        }
+        case SpellEffect::Shield:
+            world.shieldHp[target] = int(def.magnitude);
+            world.shieldUntil[target] = world.tick + def.effectTicks;
+            break;
+        case SpellEffect::None:
+            break;
+    }
+}
@@ -0,0 +1,121 @@
+#ifndef MAGEVOICE_SPELLSYSTEM_H
+#define MAGEVOICE_SPELLSYSTEM_H
+
+#include <cstdint>
+#include <vector>
+
+#include "ObstacleGrid.h"
+#include "PositionHistory.h"
+#include "SpatialGrid.h"
+#include "SpellTable.h"
+#include "World.h"
+
+struct CastRequest {
+    EntityId caster;
+    SpellType spell;
+    float targetX;
+    float targetY;
+    // Tick of the world the caster saw when aiming; hit tests rewind to it when the system has a
+    // history (see setHistory). 0 tests against the present.
+    uint32_t viewTick = 0;
+};
+
+enum class CastStatus : uint8_t {
+    Cast,
+    OnCooldown,
+    NoMana,
+    InvalidCaster
+};
+
+struct CastResult {
+    EntityId caster;
+    SpellType spell;
+    CastStatus status;
+    uint16_t hits;
+};
+
+/*!
+ * Resolves spell casts in one batch per simulation tick.
+ *
+ * Casts are queued as they arrive (voice, network) and resolve() handles all of them together:
+ * requests are validated in arrival order against a flat entity x spell table of the tick each
+ * spell becomes ready again, then every accepted cast is resolved against a spatial grid built
+ * once for the tick. Effects are accumulated and applied at the end, so all casts of a tick see
+ * the same world regardless of their order.
+ *
+ * With a PositionHistory, a cast is hit tested against the positions of the tick its caster was
+ * looking at, so a laggy caster hits what was under the cursor on their screen. Damage and
+ * effects still apply to the entities as they are now.
+ */
+class SpellSystem {
+public:
+    explicit SpellSystem(const SpellTable &table = SpellTable::defaults());
+
+    inline void queueCast(const CastRequest &request) { pending_.push_back(request); }
+
+    inline int getPendingCount() const { return (int) pending_.size(); }
+
+    /*!
+     * Resolves every queued cast at world.tick and clears the queue.
+     * @param outResults if not null, receives one result per request in queue order
+     * @param halfExtent knockback keeps players inside the square of this half extent, like
+     *                   Physics::move
+     */
+    void resolve(World &world, std::vector<CastResult> *outResults = nullptr, float halfExtent = kMapSize * 0.5f);
+
+    // Same as resolve, but knockback slides players along the solid tiles instead of a square edge;
+    // a push stops at the first solid tile on its path, however far it is
+    void resolve(World &world, const ObstacleGrid &obstacles, std::vector<CastResult> *outResults = nullptr);
+
+    /*!
+     * Pulls the target of a cast aimed farther than its spell's range back onto the edge of the
+     * range, measured from where the caster was on the tick the cast is hit tested at (so from the
+     * rewound position when it has a view tick). For casts from untrusted clients, before
+     * queueCast; a cast with an invalid caster or spell is left for resolve to reject.
+     */
+    void clampToRange(const World &world, CastRequest &cast) const;
+
+    // Tick on which the spell can next be cast by the entity
+    inline uint32_t getReadyTick(EntityId entity, SpellType spell) const {
+        size_t slot = size_t(entity) * kSpellTypeCount + static_cast<int>(spell);
+        return slot < readyTick_.size() ? readyTick_[slot] : 0;
+    }
+
+    inline const SpellTable &getTable() const { return table_; }
+
+    /*!
+     * Rewinds the hit tests of casts with a viewTick to that tick, at most maxRewindTicks back.
+     * The caller records the history, once per tick, and keeps it alive; nullptr (the default)
+     * tests every cast against the present.
+     */
+    void setHistory(const PositionHistory *history, uint32_t maxRewindTicks);
+
+private:
+    // Knockback slides along obstacles when given, otherwise clamps to halfExtent
+    void resolveCasts(World &world, std::vector<CastResult> *outResults, const ObstacleGrid *obstacles,
+                      float halfExtent);
+
+    // Past tick the cast is hit tested at, or tick itself for the present
+    uint32_t hitTestTick(const CastRequest &cast, uint32_t tick) const;
+
+    void applyHit(World &world, const SpellDefinition &def, const CastRequest &cast, EntityId target);
+
+    SpellTable table_;
+    SpatialGrid grid_;
+    const PositionHistory *history_ = nullptr;
+    uint32_t maxRewindTicks_ = 0;
+    std::vector<CastRequest> pending_;
+    std::vector<CastRequest> accepted_;
+    std::vector<int> acceptedResult_;
+    // entities x kSpellTypeCount
+    std::vector<uint32_t> readyTick_;
+
+    // Per-entity effect accumulators, only the touched entries are reset after each tick
+    std::vector<int> damage_;
+    std::vector<float> pushX_;
+    std::vector<float> pushY_;
+    std::vector<EntityId> touched_;
+    std::vector<uint8_t> isTouched_;
+};
+
+#endif //MAGEVOICE_SPELLSYSTEM_H
@@ -0,0 +1,84 @@
+#include "SpellTable.h"
+
+#include <algorithm>
+#include <sstream>
+
+#include "GameConfig.h"
+
+// One spell per line, '#' starts a comment. Times are in seconds and converted to ticks. Range is
+// how far from the caster the target may be; 10 is the view's half height, so anything on screen
+// above or below the player can be aimed at.
+static const char *kDefaultSpellTable = R"table(
+# command   mana  cooldown  damage  radius  range  shape    effect     magnitude  duration
+fireball    20    2.0       30      1.0     10     area     none       0          0
+freeze      25    5.0       0       3.0     10     area     slow       0.5        3.0
+lightning   30    3.0       25      1.5     10     nearest  none       0          0
+stone       15    10.0      0       0       0      self     shield     50         8.0
+gust        10    4.0       0       2.5     10     area     knockback  5.0        0
+)table";
+
+static bool parseShape(const std::string &name, SpellShape &out) {
+    if (name == "area") out = SpellShape::Area;
+    else if (name == "nearest") out = SpellShape::Nearest;
+    else if (name == "self") out = SpellShape::Self;
+    else return false;
+    return true;
+}
+
+static bool parseEffect(const std::string &name, SpellEffect &out) {
+    if (name == "none") out = SpellEffect::None;
+    else if (name == "slow") out = SpellEffect::Slow;
+    else if (name == "knockback") out = SpellEffect::Knockback;
+    else if (name == "shield") out = SpellEffect::Shield;
+    else return false;
+    return true;
+}
+
+const SpellTable &SpellTable::defaults() {
+    static const SpellTable table = [] {
+        SpellTable t;
+        t.parse(kDefaultSpellTable);
+        return t;
+    }();
+    return table;
+}
+
+bool SpellTable::parse(const std::string &text, std::string *outError) {
+    std::istringstream lines(text);
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(lines, line)) {
+        lineNumber++;
+        line = line.substr(0, line.find('#'));
+        std::istringstream fields(line);
+        std::string command, shape, effect;
+        float cooldown = 0.0f, duration = 0.0f;
+        int mana = 0, damage = 0;
+        SpellDefinition def;
+        if (!(fields >> command)) continue;
+
+        int type = 0;
+        while (type < kSpellTypeCount && command != spellCommand(static_cast<SpellType>(type))) type++;
+
+        bool ok = type < kSpellTypeCount
+                  && (fields >> mana >> cooldown >> damage >> def.radius >> def.range >> shape >> effect >> def.magnitude >> duration)
+                  && parseShape(shape, def.shape)
+                  && parseEffect(effect, def.effect);
+        if (!ok) {
+            if (outError) *outError = "spell table line " + std::to_string(lineNumber) + ": " + line;
+            return false;
+        }
+        def.manaCost = uint16_t(mana);
+        def.cooldownTicks = uint16_t(secondsToTicks(cooldown));
+        def.damage = int16_t(damage);
+        def.effectTicks = uint16_t(secondsToTicks(duration));
+        definitions_[type] = def;
+    }
+    return true;
+}
+
+float SpellTable::getMaxRadius() const {
+    float radius = 0.0f;
+    for (const auto &def : definitions_) radius = std::max(radius, def.radius);
+    return radius;
+}
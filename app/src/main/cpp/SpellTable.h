@@ -0,0 +1,69 @@
+#ifndef MAGEVOICE_SPELLTABLE_H
+#define MAGEVOICE_SPELLTABLE_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+#include "SpellType.h"
+
+// Who a spell hits
+enum class SpellShape : uint8_t {
+    Area,    // Every other entity within radius of the target point
+    Nearest, // The other entity closest to the target point, within radius
+    Self     // Only the caster
+};
+
+// Status applied to everything the spell hits, on top of damage
+enum class SpellEffect : uint8_t {
+    None,
+    Slow,      // magnitude = speed reduction in [0, 1]
+    Knockback, // magnitude = distance pushed away from the target point
+    Shield     // magnitude = temporary hp absorbing damage first
+};
+
+struct SpellDefinition {
+    uint16_t manaCost = 0;
+    uint16_t cooldownTicks = 0;
+    int16_t damage = 0;
+    SpellShape shape = SpellShape::Area;
+    SpellEffect effect = SpellEffect::None;
+    float radius = 0.0f;
+    // Farthest the target point may be from the caster
+    float range = 0.0f;
+    float magnitude = 0.0f;
+    uint16_t effectTicks = 0;
+};
+
+/*!
+ * Definitions of every spell, indexed by SpellType.
+ *
+ * Tables are plain text so balancing does not need a rebuild; see kDefaultSpellTable in
+ * SpellTable.cpp for the format.
+ */
+class SpellTable {
+public:
+    // Table with the values of the Kotlin Spell subclasses
+    static const SpellTable &defaults();
+
+    /*!
+     * Parses a spell table. Spells missing from the text keep their previous definition.
+     * @param outError set to a description of the first bad line on failure
+     * @return false if any line could not be parsed
+     */
+    bool parse(const std::string &text, std::string *outError = nullptr);
+
+    inline const SpellDefinition &get(SpellType type) const {
+        return definitions_[static_cast<int>(type)];
+    }
+
+    inline SpellDefinition &get(SpellType type) { return definitions_[static_cast<int>(type)]; }
+
+    // Largest radius of any spell, the cell size that makes every hit query touch few cells
+    float getMaxRadius() const;
+
+private:
+    std::array<SpellDefinition, kSpellTypeCount> definitions_{};
+};
+
+#endif //MAGEVOICE_SPELLTABLE_H
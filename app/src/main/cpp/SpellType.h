@@ -0,0 +1,30 @@
+#ifndef MAGEVOICE_SPELLTYPE_H
+#define MAGEVOICE_SPELLTYPE_H
+
+#include <cstdint>
+
+// Mirrors com.game.voicespells.game.spells.SpellType; the ordinals cross JNI, keep them in sync.
+enum class SpellType : uint8_t {
+    Fireball,
+    Freeze,
+    Lightning,
+    Stone,
+    Gust,
+    Count
+};
+
+constexpr int kSpellTypeCount = static_cast<int>(SpellType::Count);
+
+// Voice command spoken to cast each spell
+inline const char *spellCommand(SpellType type) {
+    switch (type) {
+        case SpellType::Fireball: return "fireball";
+        case SpellType::Freeze: return "freeze";
+        case SpellType::Lightning: return "lightning";
+        case SpellType::Stone: return "stone";
+        case SpellType::Gust: return "gust";
+        default: return "unknown";
+    }
+}
+
+#endif //MAGEVOICE_SPELLTYPE_H
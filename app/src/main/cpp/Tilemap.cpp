@@ -0,0 +1,132 @@
+#include "Tilemap.h"
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+// Keeps samples away from the neighbouring atlas tile when filtering
+constexpr float kAtlasInset = 1.0f / 256.0f;
+
+void Tilemap::resize(int width, int height, float tileSize) {
+    width_ = width;
+    height_ = height;
+    chunksX_ = (width + kChunkTiles - 1) / kChunkTiles;
+    chunksY_ = (height + kChunkTiles - 1) / kChunkTiles;
+    tileSize_ = tileSize;
+    originX_ = -0.5f * width * tileSize;
+    originY_ = -0.5f * height * tileSize;
+    tiles_.assign(size_t(getChunkCount()) * kChunkTiles * kChunkTiles, TileType::Grass);
+    revisions_.assign(getChunkCount(), 0);
+    obstacles_.resize(width, height, tileSize, originX_, originY_);
+}
+
+Tilemap Tilemap::makeArena(int width, int height, float rockDensity, uint64_t seed) {
+    Tilemap map;
+    map.resize(width, height);
+    for (int x = 0; x < width; x++) {
+        map.setTile(x, 0, TileType::Rock);
+        map.setTile(x, height - 1, TileType::Rock);
+    }
+    for (int y = 0; y < height; y++) {
+        map.setTile(0, y, TileType::Rock);
+        map.setTile(width - 1, y, TileType::Rock);
+    }
+
+    uint64_t state = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    auto next = [&state](int bound) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return int((state >> 33) % uint64_t(bound));
+    };
+
+    // Clusters of 1x1 to 3x3 rocks, 4 tiles on average
+    const int clearRadius = std::min(4, std::min(width, height) / 4);
+    const int clusters = int((width - 2) * (height - 2) * rockDensity / 4.0f);
+    for (int c = 0; c < clusters; c++) {
+        int w = 1 + next(3), h = 1 + next(3);
+        int x0 = 1 + next(std::max(1, width - 2 - w)), y0 = 1 + next(std::max(1, height - 2 - h));
+        for (int y = y0; y < y0 + h && y < height - 1; y++) {
+            for (int x = x0; x < x0 + w && x < width - 1; x++) {
+                if (std::abs(x - width / 2) <= clearRadius && std::abs(y - height / 2) <= clearRadius) continue;
+                map.setTile(x, y, TileType::Rock);
+            }
+        }
+    }
+    return map;
+}
+
+bool Tilemap::parse(const std::string &text, std::string *outError) {
+    std::vector<std::string> rows;
+    std::istringstream lines(text);
+    std::string line;
+    size_t width = 0;
+    while (std::getline(lines, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty() && rows.empty()) continue;
+        width = std::max(width, line.size());
+        rows.push_back(line);
+    }
+    while (!rows.empty() && rows.back().empty()) rows.pop_back();
+
+    resize(int(width), int(rows.size()), tileSize_);
+    for (size_t r = 0; r < rows.size(); r++) {
+        const int y = int(rows.size() - 1 - r);
+        for (size_t x = 0; x < rows[r].size(); x++) {
+            char c = rows[r][x];
+            if (c == '.') continue;
+            if (c != '#') {
+                if (outError) *outError = "line " + std::to_string(r + 1) + ": unknown tile '" + c + "'";
+                return false;
+            }
+            setTile(int(x), y, TileType::Rock);
+        }
+    }
+    return true;
+}
+
+void Tilemap::setTile(int tileX, int tileY, TileType type) {
+    tiles_[tileIndex(tileX, tileY)] = type;
+    obstacles_.setBlocked(tileX, tileY, isSolid(type));
+    revisions_[(tileY / kChunkTiles) * chunksX_ + tileX / kChunkTiles]++;
+}
+
+void Tilemap::bakeChunk(int chunk, ChunkMesh &out) const {
+    out.vertices.clear();
+    out.indices.clear();
+    const int firstX = (chunk % chunksX_) * kChunkTiles;
+    const int firstY = (chunk / chunksX_) * kChunkTiles;
+    const int lastX = std::min(firstX + kChunkTiles, width_);
+    const int lastY = std::min(firstY + kChunkTiles, height_);
+    const TileType *tiles = tiles_.data() + size_t(chunk) * kChunkTiles * kChunkTiles;
+
+    for (int y = firstY; y < lastY; y++) {
+        for (int x = firstX; x < lastX; x++) {
+            const int type = static_cast<int>(tiles[(y - firstY) * kChunkTiles + (x - firstX)]);
+            const float left = originX_ + x * tileSize_, right = left + tileSize_;
+            const float bottom = originY_ + y * tileSize_, top = bottom + tileSize_;
+            const float u0 = float(type) / kTileTypeCount + kAtlasInset;
+            const float u1 = float(type + 1) / kTileTypeCount - kAtlasInset;
+
+            // Same winding and uv orientation as the player quad
+            const auto base = uint16_t(out.vertices.size());
+            out.vertices.push_back({{left, bottom, 0.0f}, {u0, 1.0f}});
+            out.vertices.push_back({{right, bottom, 0.0f}, {u1, 1.0f}});
+            out.vertices.push_back({{right, top, 0.0f}, {u1, 0.0f}});
+            out.vertices.push_back({{left, top, 0.0f}, {u0, 0.0f}});
+            for (uint16_t i : {0, 1, 2, 0, 2, 3}) out.indices.push_back(uint16_t(base + i));
+        }
+    }
+}
+
+void Tilemap::findVisibleChunks(float left, float bottom, float right, float top, std::vector<int> &out) const {
+    out.clear();
+    const float chunkSize = kChunkTiles * tileSize_;
+    const int x0 = std::max(0, (int) std::floor((left - originX_) / chunkSize));
+    const int x1 = std::min(chunksX_ - 1, (int) std::floor((right - originX_) / chunkSize));
+    const int y0 = std::max(0, (int) std::floor((bottom - originY_) / chunkSize));
+    const int y1 = std::min(chunksY_ - 1, (int) std::floor((top - originY_) / chunkSize));
+    for (int y = y0; y <= y1; y++) {
+        for (int x = x0; x <= x1; x++) out.push_back(y * chunksX_ + x);
+    }
+}
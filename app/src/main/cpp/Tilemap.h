@@ -0,0 +1,99 @@
+#ifndef MAGEVOICE_TILEMAP_H
+#define MAGEVOICE_TILEMAP_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "ObstacleGrid.h"
+#include "Vertex.h"
+
+// Mirrors the game_*_tile drawables; the value is also the tile's column in the atlas
+enum class TileType : uint8_t {
+    Grass,
+    Rock,
+    Count
+};
+
+constexpr int kTileTypeCount = static_cast<int>(TileType::Count);
+
+inline bool isSolid(TileType type) { return type == TileType::Rock; }
+
+// Static geometry of one chunk, ready for a vertex and an index buffer
+struct ChunkMesh {
+    std::vector<Vertex> vertices;
+    std::vector<uint16_t> indices;
+};
+
+/*!
+ * Static level made of square tiles, stored and drawn in kChunkTiles x kChunkTiles chunks.
+ *
+ * Tiles of a chunk are contiguous, so baking a chunk reads one block of memory. Each chunk is
+ * baked once into a mesh the renderer uploads to a static buffer and draws with a single call;
+ * the revision counter tells it when a tile change needs a new upload. The map is centred on
+ * the origin with tile (0, 0) at the bottom left, and keeps an ObstacleGrid of its solid tiles
+ * in sync for movement collision.
+ */
+class Tilemap {
+public:
+    static constexpr int kChunkTiles = 16;
+
+    // All grass
+    void resize(int width, int height, float tileSize = 1.0f);
+
+    /*!
+     * Rock border and scattered rock clusters covering about rockDensity of the inside, with
+     * the centre kept clear for spawning. Same seed, same map.
+     */
+    static Tilemap makeArena(int width, int height, float rockDensity, uint64_t seed);
+
+    /*!
+     * Parses a map, one text line per tile row, top row first: '.' grass, '#' rock. Rows may be
+     * ragged; missing tiles are grass.
+     * @param outError set to a description of the first bad character on failure
+     */
+    bool parse(const std::string &text, std::string *outError = nullptr);
+
+    inline TileType getTile(int tileX, int tileY) const { return tiles_[tileIndex(tileX, tileY)]; }
+
+    void setTile(int tileX, int tileY, TileType type);
+
+    // Geometry of every tile of the chunk: world space quads with z = 0 and atlas uvs
+    void bakeChunk(int chunk, ChunkMesh &out) const;
+
+    // Chunks overlapping the rectangle (world units), row by row
+    void findVisibleChunks(float left, float bottom, float right, float top, std::vector<int> &out) const;
+
+    // Bumped by every tile change in the chunk
+    inline uint32_t getChunkRevision(int chunk) const { return revisions_[chunk]; }
+
+    inline const ObstacleGrid &getObstacles() const { return obstacles_; }
+
+    inline int getWidth() const { return width_; }
+
+    inline int getHeight() const { return height_; }
+
+    inline int getChunkCount() const { return chunksX_ * chunksY_; }
+
+    inline float getTileSize() const { return tileSize_; }
+
+private:
+    inline size_t tileIndex(int tileX, int tileY) const {
+        int chunk = (tileY / kChunkTiles) * chunksX_ + tileX / kChunkTiles;
+        return size_t(chunk) * kChunkTiles * kChunkTiles + (tileY % kChunkTiles) * kChunkTiles + tileX % kChunkTiles;
+    }
+
+    int width_ = 0;
+    int height_ = 0;
+    int chunksX_ = 0;
+    int chunksY_ = 0;
+    float tileSize_ = 1.0f;
+    float originX_ = 0.0f;
+    float originY_ = 0.0f;
+    // Chunk-major; chunks on the right and top edges are padded with grass
+    std::vector<TileType> tiles_;
+    std::vector<uint32_t> revisions_;
+    ObstacleGrid obstacles_;
+};
+
+#endif //MAGEVOICE_TILEMAP_H
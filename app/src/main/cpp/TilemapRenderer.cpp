@@ -0,0 +1,93 @@
+#include "TilemapRenderer.h"
+
+#include "Shader.h"
+#include "Utility.h"
+
+// Atlas tile edge in pixels; tiles sit side by side in TileType order
+constexpr int kAtlasTilePixels = 16;
+
+TilemapRenderer::TilemapRenderer(const Tilemap &map, GpuResourceCache &resources)
+        : map_(map),
+          resources_(resources),
+          atlas_(resources.addTexture(kAtlasTilePixels * kTileTypeCount, kAtlasTilePixels, paintAtlas())),
+          chunks_(map.getChunkCount()) {}
+
+TilemapRenderer::~TilemapRenderer() { releaseGpu(false); }
+
+void TilemapRenderer::releaseGpu(bool contextLost) {
+    for (ChunkBuffers &chunk : chunks_) {
+        if (chunk.uploaded && !contextLost) {
+            glDeleteBuffers(1, &chunk.vertexBuffer);
+            glDeleteBuffers(1, &chunk.indexBuffer);
+        }
+        chunk = ChunkBuffers();
+    }
+}
+
+void TilemapRenderer::draw(const Shader &shader, float left, float bottom, float right, float top) {
+    map_.findVisibleChunks(left, bottom, right, top, visible_);
+
+    float identity[16];
+    Utility::buildIdentityMatrix(identity);
+    shader.setModelMatrix(identity);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, resources_.getTexture(atlas_));
+    glDisable(GL_DEPTH_TEST);
+
+    for (int chunk : visible_) {
+        ChunkBuffers &buffers = chunks_[chunk];
+        if (!buffers.uploaded || buffers.revision != map_.getChunkRevision(chunk)) upload(chunk);
+        shader.bindBufferedMesh(buffers.vertexBuffer, buffers.indexBuffer);
+        shader.drawBufferedMesh(buffers.indexCount);
+    }
+
+    shader.unbindMesh();
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    glEnable(GL_DEPTH_TEST);
+}
+
+void TilemapRenderer::upload(int chunk) {
+    ChunkBuffers &buffers = chunks_[chunk];
+    if (!buffers.uploaded) {
+        glGenBuffers(1, &buffers.vertexBuffer);
+        glGenBuffers(1, &buffers.indexBuffer);
+    }
+    map_.bakeChunk(chunk, mesh_);
+    glBindBuffer(GL_ARRAY_BUFFER, buffers.vertexBuffer);
+    glBufferData(GL_ARRAY_BUFFER, mesh_.vertices.size() * sizeof(Vertex), mesh_.vertices.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffers.indexBuffer);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, mesh_.indices.size() * sizeof(uint16_t), mesh_.indices.data(),
+                 GL_STATIC_DRAW);
+    buffers.indexCount = GLsizei(mesh_.indices.size());
+    buffers.revision = map_.getChunkRevision(chunk);
+    buffers.uploaded = true;
+}
+
+// Pixel versions of game_background_tile.xml and game_obstacle.xml, RGBA bytes in memory order
+std::vector<uint32_t> TilemapRenderer::paintAtlas() {
+    const int width = kAtlasTilePixels * kTileTypeCount;
+    std::vector<uint32_t> pixels(width * kAtlasTilePixels);
+    auto put = [&](int tile, int x, int y, uint32_t rgb) {
+        uint32_t abgr = 0xFF000000u | ((rgb & 0xFF) << 16) | (rgb & 0xFF00) | ((rgb >> 16) & 0xFF);
+        pixels[y * width + tile * kAtlasTilePixels + x] = abgr;
+    };
+
+    const int grass = static_cast<int>(TileType::Grass);
+    const int rock = static_cast<int>(TileType::Rock);
+    for (int y = 0; y < kAtlasTilePixels; y++) {
+        for (int x = 0; x < kAtlasTilePixels; x++) {
+            // Grass: flat green with small darker arcs on a 4 pixel pattern
+            bool blade = (y % 4 == 2 && x % 8 >= 2 && x % 8 <= 5) || (y % 4 == 1 && (x % 8 == 1 || x % 8 == 6));
+            put(grass, x, y, blade ? 0x407040 : 0x508050);
+
+            // Rock: grey block with a dark outline and horizontal strata on a dark ground
+            bool inside = x >= 2 && x <= 13 && y >= 2 && y <= 13;
+            bool outline = inside && (x == 2 || x == 13 || y == 2 || y == 13);
+            bool stratum = inside && (y == 5 || y == 7 || y == 10);
+            put(rock, x, y, !inside || outline ? 0x444444 : (stratum ? 0x555555 : 0x666666));
+        }
+    }
+
+    return pixels;
+}
@@ -0,0 +1,63 @@
+#ifndef MAGEVOICE_TILEMAPRENDERER_H
+#define MAGEVOICE_TILEMAPRENDERER_H
+
+#include <GLES3/gl3.h>
+#include <cstdint>
+#include <vector>
+
+#include "GpuResourceCache.h"
+#include "Tilemap.h"
+
+class Shader;
+
+/*!
+ * Draws a Tilemap with one glDrawElements per visible chunk.
+ *
+ * A chunk is baked and uploaded to static vertex and index buffers the first time it is in
+ * view, and again only if its tiles changed since. Chunks outside the view rectangle cost
+ * nothing. The tilemap is the CPU copy of the chunk buffers, so after releaseGpu() they are
+ * simply baked again as they come into view.
+ */
+class TilemapRenderer {
+public:
+    // Registers the tile atlas in the cache; no GL calls
+    TilemapRenderer(const Tilemap &map, GpuResourceCache &resources);
+    ~TilemapRenderer();
+
+    TilemapRenderer(const TilemapRenderer &) = delete;
+    TilemapRenderer &operator=(const TilemapRenderer &) = delete;
+
+    /*!
+     * Draws the chunks overlapping the view rectangle (world units) with depth testing off, so
+     * everything drawn afterwards lands on top. The shader must be active.
+     */
+    void draw(const Shader &shader, float left, float bottom, float right, float top);
+
+    // Drops the chunk buffers; with contextLost the handles are forgotten without calling GL
+    void releaseGpu(bool contextLost);
+
+    // Chunks drawn by the last draw()
+    inline int getDrawCount() const { return (int) visible_.size(); }
+
+private:
+    struct ChunkBuffers {
+        GLuint vertexBuffer = 0;
+        GLuint indexBuffer = 0;
+        GLsizei indexCount = 0;
+        bool uploaded = false;
+        uint32_t revision = 0;
+    };
+
+    void upload(int chunk);
+
+    static std::vector<uint32_t> paintAtlas();
+
+    const Tilemap &map_;
+    GpuResourceCache &resources_;
+    GpuResourceCache::TextureId atlas_;
+    std::vector<ChunkBuffers> chunks_;
+    std::vector<int> visible_;
+    ChunkMesh mesh_;
+};
+
+#endif //MAGEVOICE_TILEMAPRENDERER_H
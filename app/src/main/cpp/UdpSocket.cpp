@@ -0,0 +1,100 @@
+#include "UdpSocket.h"
+
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstdlib>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+bool NetAddress::parse(const std::string &text, NetAddress &outAddress) {
+    size_t colon = text.rfind(':');
+    if (colon == std::string::npos) return false;
+    in_addr ip{};
+    if (inet_pton(AF_INET, text.substr(0, colon).c_str(), &ip) != 1) return false;
+    int port = std::atoi(text.c_str() + colon + 1);
+    if (port <= 0 || port > 65535) return false;
+    outAddress.ip = ip.s_addr;
+    outAddress.port = htons(uint16_t(port));
+    return true;
+}
+
+std::string NetAddress::toString() const {
+    char buffer[INET_ADDRSTRLEN] = {};
+    in_addr address{};
+    address.s_addr = ip;
+    inet_ntop(AF_INET, &address, buffer, sizeof(buffer));
+    return std::string(buffer) + ":" + std::to_string(ntohs(port));
+}
+
+UdpSocket::~UdpSocket() { close(); }
+
+UdpSocket::UdpSocket(UdpSocket &&other) noexcept : fd_(other.fd_) { other.fd_ = -1; }
+
+UdpSocket &UdpSocket::operator=(UdpSocket &&other) noexcept {
+    if (this != &other) {
+        close();
+        fd_ = other.fd_;
+        other.fd_ = -1;
+    }
+    return *this;
+}
+
+bool UdpSocket::open(uint16_t port, int bufferBytes) {
+    close();
+    fd_ = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd_ < 0) return false;
+
+    if (bufferBytes > 0) {
+        setsockopt(fd_, SOL_SOCKET, SO_RCVBUF, &bufferBytes, sizeof(bufferBytes));
+        setsockopt(fd_, SOL_SOCKET, SO_SNDBUF, &bufferBytes, sizeof(bufferBytes));
+    }
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(port);
+    if (bind(fd_, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0
+        || fcntl(fd_, F_SETFL, fcntl(fd_, F_GETFL, 0) | O_NONBLOCK) != 0) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void UdpSocket::close() {
+    if (fd_ >= 0) ::close(fd_);
+    fd_ = -1;
+}
+
+uint16_t UdpSocket::getLocalPort() const {
+    sockaddr_in address{};
+    socklen_t length = sizeof(address);
+    if (fd_ < 0 || getsockname(fd_, reinterpret_cast<sockaddr *>(&address), &length) != 0) return 0;
+    return ntohs(address.sin_port);
+}
+
+bool UdpSocket::sendTo(const NetAddress &to, const uint8_t *data, size_t size) {
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = to.ip;
+    address.sin_port = to.port;
+    return sendto(fd_, data, size, 0, reinterpret_cast<sockaddr *>(&address), sizeof(address)) == ssize_t(size);
+}
+
+int UdpSocket::receiveFrom(uint8_t *buffer, size_t capacity, NetAddress &outFrom) {
+    sockaddr_in address{};
+    socklen_t length = sizeof(address);
+    ssize_t received = recvfrom(fd_, buffer, capacity, 0, reinterpret_cast<sockaddr *>(&address), &length);
+    if (received < 0) return errno == EAGAIN || errno == EWOULDBLOCK ? kNothingPending : kError;
+    outFrom.ip = address.sin_addr.s_addr;
+    outFrom.port = address.sin_port;
+    return int(received);
+}
+
+bool UdpSocket::waitReadable(int timeoutMs) {
+    pollfd descriptor{fd_, POLLIN, 0};
+    return poll(&descriptor, 1, timeoutMs) > 0;
+}
@@ -0,0 +1,73 @@
+#ifndef MAGEVOICE_UDPSOCKET_H
+#define MAGEVOICE_UDPSOCKET_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// IPv4 endpoint, both fields in network byte order
+struct NetAddress {
+    uint32_t ip = 0;
+    uint16_t port = 0;
+
+    inline bool operator==(const NetAddress &other) const { return ip == other.ip && port == other.port; }
+
+    // Unique per endpoint, for hash maps
+    inline uint64_t key() const { return (uint64_t(ip) << 16) | port; }
+
+    // Parses "a.b.c.d:port"
+    static bool parse(const std::string &text, NetAddress &outAddress);
+
+    std::string toString() const;
+};
+
+/*!
+ * Non-blocking IPv4 UDP socket (POSIX).
+ *
+ * Closed on destruction; movable but not copyable.
+ */
+class UdpSocket {
+public:
+    UdpSocket() = default;
+    ~UdpSocket();
+
+    UdpSocket(const UdpSocket &) = delete;
+    UdpSocket &operator=(const UdpSocket &) = delete;
+    UdpSocket(UdpSocket &&other) noexcept;
+    UdpSocket &operator=(UdpSocket &&other) noexcept;
+
+    /*!
+     * Binds to the port on every interface.
+     * @param port 0 for an ephemeral port, see getLocalPort()
+     * @param bufferBytes kernel send and receive buffer size, 0 keeps the system default
+     */
+    bool open(uint16_t port, int bufferBytes = 0);
+
+    void close();
+
+    inline bool isOpen() const { return fd_ >= 0; }
+
+    // Bound port in host byte order
+    uint16_t getLocalPort() const;
+
+    bool sendTo(const NetAddress &to, const uint8_t *data, size_t size);
+
+    // Returned by receiveFrom when no datagram is pending
+    static constexpr int kNothingPending = -1;
+    // Returned by receiveFrom when the socket failed
+    static constexpr int kError = -2;
+
+    /*!
+     * @return bytes received, which is 0 for an empty datagram (valid UDP, so drain loops must
+     *         skip it and go on), or kNothingPending or kError
+     */
+    int receiveFrom(uint8_t *buffer, size_t capacity, NetAddress &outFrom);
+
+    // Blocks until a datagram is pending or the timeout expires; @return true if one is pending
+    bool waitReadable(int timeoutMs);
+
+private:
+    int fd_ = -1;
+};
+
+#endif //MAGEVOICE_UDPSOCKET_H
@@ -0,0 +1,110 @@
+#include "WavFile.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+static uint32_t readLe32(const uint8_t *p) {
+    return uint32_t(p[0]) | (uint32_t(p[1]) << 8) | (uint32_t(p[2]) << 16) | (uint32_t(p[3]) << 24);
+}
+
+static uint16_t readLe16(const uint8_t *p) {
+    return uint16_t(p[0] | (p[1] << 8));
+}
+
+static void writeLe32(std::ostream &out, uint32_t v) {
+    const char bytes[4] = {char(v), char(v >> 8), char(v >> 16), char(v >> 24)};
+    out.write(bytes, 4);
+}
+
+static void writeLe16(std::ostream &out, uint16_t v) {
+    const char bytes[2] = {char(v), char(v >> 8)};
+    out.write(bytes, 2);
+}
+
+bool WavFile::parse(const uint8_t *data, size_t size, WavData &out) {
+    if (size < 12 || std::memcmp(data, "RIFF", 4) != 0 || std::memcmp(data + 8, "WAVE", 4) != 0) {
+        return false;
+    }
+
+    int channels = 0;
+    int bitsPerSample = 0;
+    int format = 0;
+    size_t offset = 12;
+    while (offset + 8 <= size) {
+        const uint8_t *chunk = data + offset;
+        size_t chunkSize = readLe32(chunk + 4);
+        const uint8_t *body = chunk + 8;
+        size_t available = size - offset - 8;
+        if (chunkSize > available) chunkSize = available;
+
+        if (std::memcmp(chunk, "fmt ", 4) == 0 && chunkSize >= 16) {
+            format = readLe16(body);
+            channels = readLe16(body + 2);
+            out.sampleRate = int(readLe32(body + 4));
+            bitsPerSample = readLe16(body + 14);
+        } else if (std::memcmp(chunk, "data", 4) == 0) {
+            // WAVE_FORMAT_PCM or WAVE_FORMAT_EXTENSIBLE carrying PCM
+            if ((format != 1 && format != 0xFFFE) || bitsPerSample != 16 || channels <= 0) return false;
+            size_t frames = chunkSize / (2 * channels);
+            out.samples.resize(frames);
+            for (size_t i = 0; i < frames; i++) {
+                int sum = 0;
+                for (int c = 0; c < channels; c++) {
+                    sum += int16_t(readLe16(body + (i * channels + c) * 2));
+                }
+                out.samples[i] = int16_t(sum / channels);
+            }
+            return true;
+        }
+        offset += 8 + chunkSize + (chunkSize & 1);
+    }
+    return false;
+}
+
+bool WavFile::load(const std::string &path, WavData &out) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return false;
+    std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    return parse(bytes.data(), bytes.size(), out);
+}
+
+bool WavFile::save(const std::string &path, const WavData &wav) {
+    std::ofstream file(path, std::ios::binary);
+    if (!file) return false;
+    uint32_t dataSize = uint32_t(wav.samples.size() * 2);
+    file.write("RIFF", 4);
+    writeLe32(file, 36 + dataSize);
+    file.write("WAVEfmt ", 8);
+    writeLe32(file, 16);
+    writeLe16(file, 1);
+    writeLe16(file, 1);
+    writeLe32(file, uint32_t(wav.sampleRate));
+    writeLe32(file, uint32_t(wav.sampleRate * 2));
+    writeLe16(file, 2);
+    writeLe16(file, 16);
+    file.write("data", 4);
+    writeLe32(file, dataSize);
+    for (int16_t s : wav.samples) writeLe16(file, uint16_t(s));
+    return bool(file);
+}
+
+void WavFile::resample(WavData &wav, int sampleRate) {
+    if (wav.sampleRate == sampleRate || wav.sampleRate <= 0 || wav.samples.empty()) {
+        wav.sampleRate = sampleRate;
+        return;
+    }
+    const double step = double(wav.sampleRate) / sampleRate;
+    size_t count = size_t(wav.samples.size() / step);
+    std::vector<int16_t> resampled(count);
+    for (size_t i = 0; i < count; i++) {
+        double pos = i * step;
+        size_t i0 = size_t(pos);
+        size_t i1 = std::min(i0 + 1, wav.samples.size() - 1);
+        double frac = pos - i0;
+        resampled[i] = int16_t(wav.samples[i0] * (1.0 - frac) + wav.samples[i1] * frac);
+    }
+    wav.samples.swap(resampled);
+    wav.sampleRate = sampleRate;
+}
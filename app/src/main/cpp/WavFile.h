@@ -0,0 +1,31 @@
+#ifndef MAGEVOICE_WAVFILE_H
+#define MAGEVOICE_WAVFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Decoded 16-bit PCM, downmixed to mono
+struct WavData {
+    int sampleRate = 0;
+    std::vector<int16_t> samples;
+};
+
+class WavFile {
+public:
+    /*!
+     * Parses a RIFF/WAVE image holding 16-bit integer PCM. Multi-channel audio is averaged.
+     * @return false if the data is not a supported WAV
+     */
+    static bool parse(const uint8_t *data, size_t size, WavData &out);
+
+    static bool load(const std::string &path, WavData &out);
+
+    static bool save(const std::string &path, const WavData &wav);
+
+    // Linear resampling, enough to bring test recordings to the spotter rate
+    static void resample(WavData &wav, int sampleRate);
+};
+
+#endif //MAGEVOICE_WAVFILE_H
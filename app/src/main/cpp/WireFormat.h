@@ -0,0 +1,45 @@
+#ifndef MAGEVOICE_WIREFORMAT_H
+#define MAGEVOICE_WIREFORMAT_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*!
+ * Little endian field encoding shared by the network codecs (NetMessage, ReplicationPacket).
+ *
+ * Positions are fixed point i16 with kPositionScale steps per world unit, which covers
+ * +-512 units at 1/64 unit precision.
+ */
+class WireFormat {
+public:
+    static constexpr float kPositionScale = 64.0f;
+    // Largest datagram either side reads; every message fits a typical 1500 byte MTU
+    static constexpr size_t kMaxDatagramBytes = 1500;
+
+    static inline void put16(std::vector<uint8_t> &out, uint16_t v) {
+        out.push_back(uint8_t(v));
+        out.push_back(uint8_t(v >> 8));
+    }
+
+    static inline void put32(std::vector<uint8_t> &out, uint32_t v) {
+        for (int i = 0; i < 4; i++) out.push_back(uint8_t(v >> (8 * i)));
+    }
+
+    static inline uint16_t get16(const uint8_t *p) { return uint16_t(p[0] | (p[1] << 8)); }
+
+    static inline uint32_t get32(const uint8_t *p) {
+        return uint32_t(p[0]) | (uint32_t(p[1]) << 8) | (uint32_t(p[2]) << 16) | (uint32_t(p[3]) << 24);
+    }
+
+    static inline void putPosition(std::vector<uint8_t> &out, float v) {
+        float scaled = std::clamp(std::round(v * kPositionScale), -32768.0f, 32767.0f);
+        put16(out, uint16_t(int16_t(scaled)));
+    }
+
+    static inline float getPosition(const uint8_t *p) { return int16_t(get16(p)) / kPositionScale; }
+};
+
+#endif //MAGEVOICE_WIREFORMAT_H
@@ -0,0 +1,64 @@
+#ifndef MAGEVOICE_WORLD_H
+#define MAGEVOICE_WORLD_H
+
+#include <cstdint>
+#include <vector>
+
+#include "GameConfig.h"
+
+using EntityId = uint32_t;
+
+/*!
+ * Struct-of-arrays entity storage for the native simulation.
+ *
+ * Entities are dense indices into every array, so systems walk contiguous memory instead of
+ * chasing map nodes. Timed status effects store the tick they expire on, which means nothing
+ * has to run to clear them.
+ */
+struct World {
+    uint32_t tick = 0;
+
+    std::vector<float> posX;
+    std::vector<float> posY;
+    std::vector<float> velX;
+    std::vector<float> velY;
+    std::vector<int> hp;
+    std::vector<int> mana;
+    std::vector<uint8_t> alive;
+
+    std::vector<int> shieldHp;
+    std::vector<uint32_t> shieldUntil;
+    std::vector<float> slowPotency;
+    std::vector<uint32_t> slowUntil;
+
+    inline int size() const { return (int) posX.size(); }
+
+    EntityId add(float x, float y) {
+        posX.push_back(x);
+        posY.push_back(y);
+        velX.push_back(0.0f);
+        velY.push_back(0.0f);
+        hp.push_back(kMaxHp);
+        mana.push_back(kMaxMana);
+        alive.push_back(1);
+        shieldHp.push_back(0);
+        shieldUntil.push_back(0);
+        slowPotency.push_back(0.0f);
+        slowUntil.push_back(0);
+        return EntityId(posX.size() - 1);
+    }
+
+    void clear() {
+        tick = 0;
+        for (auto *v : {&posX, &posY, &velX, &velY, &slowPotency}) v->clear();
+        for (auto *v : {&hp, &mana, &shieldHp}) v->clear();
+        for (auto *v : {&shieldUntil, &slowUntil}) v->clear();
+        alive.clear();
+    }
+
+    inline float speedMultiplier(EntityId e) const {
+        return tick < slowUntil[e] ? 1.0f - slowPotency[e] : 1.0f;
+    }
+};
+
+#endif //MAGEVOICE_WORLD_H
@@ -0,0 +1,77 @@
+#ifndef MAGEVOICE_BENCHUTIL_H
+#define MAGEVOICE_BENCHUTIL_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+// Shared helpers for the host benchmarks. Every benchmark accepts --quick, which shrinks the
+// workload so it can run as a ctest smoke test.
+
+class Stopwatch {
+public:
+    Stopwatch() : start_(std::chrono::steady_clock::now()) {}
+
+    void restart() { start_ = std::chrono::steady_clock::now(); }
+
+    double elapsedMs() const {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_).count();
+    }
+
+private:
+    std::chrono::steady_clock::time_point start_;
+};
+
+// p in [0, 100]; sorts a copy
+inline double percentile(std::vector<double> values, double p) {
+    if (values.empty()) return 0.0;
+    std::sort(values.begin(), values.end());
+    double rank = p / 100.0 * (values.size() - 1);
+    size_t lo = size_t(rank);
+    size_t hi = std::min(lo + 1, values.size() - 1);
+    return values[lo] + (values[hi] - values[lo]) * (rank - lo);
+}
+
+inline bool hasFlag(int argc, char **argv, const char *flag) {
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], flag) == 0) return true;
+    }
+    return false;
+}
+
+// Value following "name", or fallback when absent
+inline const char *optionValue(int argc, char **argv, const char *name, const char *fallback = nullptr) {
+    for (int i = 1; i + 1 < argc; i++) {
+        if (std::strcmp(argv[i], name) == 0) return argv[i + 1];
+    }
+    return fallback;
+}
+
+inline int optionInt(int argc, char **argv, const char *name, int fallback) {
+    const char *value = optionValue(argc, argv, name);
+    return value ? std::atoi(value) : fallback;
+}
+
+// Deterministic generator so runs are comparable
+class BenchRandom {
+public:
+    explicit BenchRandom(uint64_t seed) : state_(seed * 6364136223846793005ULL + 1442695040888963407ULL) {}
+
+    uint32_t next() {
+        state_ ^= state_ << 13;
+        state_ ^= state_ >> 7;
+        state_ ^= state_ << 17;
+        return uint32_t(state_ >> 32);
+    }
+
+    // Uniform in [lo, hi)
+    float uniform(float lo, float hi) { return lo + (hi - lo) * (next() / 4294967296.0f); }
+
+private:
+    uint64_t state_;
+};
+
+#endif //MAGEVOICE_BENCHUTIL_H
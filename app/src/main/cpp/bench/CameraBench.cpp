@@ -0,0 +1,127 @@
+// Camera culling before batching, over a world much larger than the screen.
+//
+//   CameraBench [--quick] [--entities N] [--frames F]
+//
+// Wandering entities fill a square world at a fixed density while the camera follows one of
+// them. Every frame the view is culled with the branch free Camera::cull and with a branchy
+// loop over Camera::isVisible (which must agree), then the render queue records and sorts
+// either the visible entities only or all of them, as the renderer did before culling. Last,
+// the target stops and the number of frames that would upload a new view matrix is counted.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "BenchUtil.h"
+#include "Camera.h"
+#include "Physics.h"
+#include "RenderQueue.h"
+
+// Entities per square unit
+constexpr float kDensity = 0.1f;
+constexpr float kViewHalfHeight = 10.0f;
+constexpr float kEntityHalfSize = 0.5f;
+// Phone in landscape
+constexpr int kViewportWidth = 2400;
+constexpr int kViewportHeight = 1080;
+
+static void record(RenderQueue &queue, const World &world, const uint32_t *indices, int count, const ViewRect &view) {
+    queue.beginFrame(1);
+    RenderQueue::Buffer &buffer = queue.getBuffer(0);
+    for (int i = 0; i < count; i++) {
+        const uint32_t e = indices[i];
+        float depth = (world.posY[e] - view.bottom) / (view.top - view.bottom);
+        buffer.draw(RenderKey::make(0, 0, 0, depth, 0), world.posX[e], world.posY[e], 0.0f);
+    }
+    queue.sort();
+}
+
+int main(int argc, char **argv) {
+    const bool quick = hasFlag(argc, argv, "--quick");
+    const int entities = optionInt(argc, argv, "--entities", quick ? 20000 : 100000);
+    const int frames = optionInt(argc, argv, "--frames", quick ? 60 : 600);
+
+    const float halfExtent = 0.5f * std::sqrt(entities / kDensity);
+    BenchRandom rng(entities);
+    World world;
+    for (int e = 0; e < entities; e++) {
+        EntityId id = world.add(rng.uniform(-halfExtent, halfExtent), rng.uniform(-halfExtent, halfExtent));
+        world.velX[id] = rng.uniform(-1.0f, 1.0f);
+        world.velY[id] = rng.uniform(-1.0f, 1.0f);
+    }
+
+    Camera camera(kViewHalfHeight);
+    camera.setViewport(kViewportWidth, kViewportHeight);
+    camera.setWorldBounds({-halfExtent, -halfExtent, halfExtent, halfExtent});
+    camera.snapTo(world.posX[0], world.posY[0]);
+    std::printf("%d entities in a %.0f x %.0f world, view %.1f x %.1f\n", entities, 2 * halfExtent, 2 * halfExtent,
+                2 * camera.getHalfWidth(), 2 * camera.getHalfHeight());
+
+    std::vector<uint32_t> visible(entities), all(entities);
+    for (int e = 0; e < entities; e++) all[e] = uint32_t(e);
+    std::vector<uint32_t> branchy;
+    branchy.reserve(entities);
+    RenderQueue culledQueue, fullQueue;
+    double cullMs = 0.0, branchyMs = 0.0, culledBatchMs = 0.0, fullBatchMs = 0.0, visibleSum = 0.0;
+    int uploads = 0;
+    uint32_t uploadedRevision = 0;
+
+    for (int f = 0; f < frames; f++) {
+        Physics::move(world, 0, entities, kTickSeconds, halfExtent);
+        camera.follow(world.posX[0], world.posY[0], kTickSeconds);
+        if (camera.getRevision() != uploadedRevision) {
+            uploadedRevision = camera.getRevision();
+            uploads++;
+        }
+
+        Stopwatch culling;
+        const int count = camera.cull(world.posX.data(), world.posY.data(), entities, kEntityHalfSize, visible.data());
+        cullMs += culling.elapsedMs();
+
+        Stopwatch branching;
+        branchy.clear();
+        for (int e = 0; e < entities; e++) {
+            if (camera.isVisible(world.posX[e], world.posY[e], kEntityHalfSize)) branchy.push_back(uint32_t(e));
+        }
+        branchyMs += branching.elapsedMs();
+        if (int(branchy.size()) != count || !std::equal(branchy.begin(), branchy.end(), visible.begin())) {
+            std::fprintf(stderr, "frame %d: cull found %d entities, isVisible %zu\n", f, count, branchy.size());
+            return 1;
+        }
+        visibleSum += count;
+
+        const ViewRect view = camera.getVisibleRect();
+        Stopwatch culledBatch;
+        record(culledQueue, world, visible.data(), count, view);
+        culledBatchMs += culledBatch.elapsedMs();
+        Stopwatch fullBatch;
+        record(fullQueue, world, all.data(), entities, view);
+        fullBatchMs += fullBatch.elapsedMs();
+    }
+    const int movingUploads = uploads;
+
+    // The target stops: the camera settles, then stops asking for uploads
+    world.velX[0] = world.velY[0] = 0.0f;
+    uploads = 0;
+    for (int f = 0; f < frames; f++) {
+        camera.follow(world.posX[0], world.posY[0], kTickSeconds);
+        if (camera.getRevision() != uploadedRevision) {
+            uploadedRevision = camera.getRevision();
+            uploads++;
+        }
+    }
+    if (uploads == frames) {
+        std::fprintf(stderr, "camera never settled on a resting target\n");
+        return 1;
+    }
+
+    std::printf("%12s %12s %12s %12s %12s %12s\n", "visible", "cull us", "branchy us", "cull M/s",
+                "batch us", "no-cull us");
+    std::printf("%12.1f %12.1f %12.1f %12.0f %12.1f %12.1f\n", visibleSum / frames, cullMs * 1000.0 / frames,
+                branchyMs * 1000.0 / frames, entities * frames / (cullMs * 1000.0), culledBatchMs * 1000.0 / frames,
+                fullBatchMs * 1000.0 / frames);
+    std::printf("view uploads: %d of %d frames while moving, %d of %d after the target stopped\n", movingUploads,
+                frames, uploads, frames);
+    return 0;
+}
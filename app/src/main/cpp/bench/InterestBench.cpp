@@ -0,0 +1,116 @@
+// Per-client replication bandwidth with area-of-interest filtering.
+//
+//   InterestBench [--quick] [--ticks T] [--budget BYTES] [--area UNITS]
+//
+// Every client controls one wandering player in a square arena and a few percent of the players
+// cast a spell each tick. Packets are decoded on the "client" side to measure how stale nearby
+// entities get. The baseline is today's broadcast of every player to every peer, both as the
+// binary packet and as the JSON SyncJsonUtil produces.
+
+#include <cstdio>
+#include <vector>
+
+#include "BenchUtil.h"
+#include "InterestManager.h"
+
+// Size of one player object in SyncJsonUtil.playerStatesToJson, measured on typical values
+constexpr int kJsonBytesPerPlayer = 72;
+
+int main(int argc, char **argv) {
+    const bool quick = hasFlag(argc, argv, "--quick");
+    const int ticks = optionInt(argc, argv, "--ticks", quick ? 60 : 600);
+    const int budget = optionInt(argc, argv, "--budget", 400);
+    const float area = float(optionInt(argc, argv, "--area", 300));
+    std::vector<int> clientCounts = quick ? std::vector<int>{50, 200} : std::vector<int>{100, 200, 400, 800};
+
+    std::printf("arena %.0f x %.0f units, budget %d B/tick, %d ticks at %d Hz\n", area, area, budget, ticks, kTickRate);
+    std::printf("%7s %12s %12s %12s %14s %14s %11s %11s\n", "clients", "AoI KB/s", "AoI p95", "update ms",
+                "broadcast KB/s", "JSON KB/s", "near age", "events lost");
+
+    for (int clients : clientCounts) {
+        World world;
+        BenchRandom rng(42);
+        std::vector<float> headingX(clients), headingY(clients);
+        for (int i = 0; i < clients; i++) {
+            world.add(rng.uniform(-area / 2, area / 2), rng.uniform(-area / 2, area / 2));
+        }
+
+        InterestConfig config;
+        config.packetBudget = budget;
+        InterestManager interest(config);
+        for (int i = 0; i < clients; i++) interest.addClient(EntityId(i));
+
+        // Client side view: tick each entity was last received
+        std::vector<uint32_t> received(size_t(clients) * clients, 0);
+        std::vector<double> nearAges;
+        std::vector<SpellEvent> events, decodedEvents;
+        std::vector<EntitySnapshot> decodedEntities;
+        double updateMs = 0.0;
+        const float nearSq = config.bands[0].radius * config.bands[0].radius;
+
+        for (int t = 0; t < ticks; t++) {
+            world.tick = uint32_t(t);
+            for (int i = 0; i < clients; i++) {
+                if (t % 60 == 0) {
+                    headingX[i] = rng.uniform(-1.0f, 1.0f);
+                    headingY[i] = rng.uniform(-1.0f, 1.0f);
+                }
+                world.posX[i] = std::clamp(world.posX[i] + headingX[i] * kPlayerSpeed * kTickSeconds, -area / 2, area / 2);
+                world.posY[i] = std::clamp(world.posY[i] + headingY[i] * kPlayerSpeed * kTickSeconds, -area / 2, area / 2);
+            }
+            events.clear();
+            for (int i = 0; i < clients; i++) {
+                if (rng.next() % 100 < 2) {
+                    events.push_back({EntityId(i), static_cast<SpellType>(rng.next() % kSpellTypeCount),
+                                      world.posX[i] + 3.0f, world.posY[i], world.tick});
+                }
+            }
+
+            Stopwatch update;
+            interest.update(world, events);
+            updateMs += update.elapsedMs();
+
+            for (int c = 0; c < clients; c++) {
+                const auto &packet = interest.getPacket(c);
+                uint32_t tick;
+                ReplicationPacket::read(packet.data(), packet.size(), tick, decodedEvents, decodedEntities);
+                uint32_t *row = received.data() + size_t(c) * clients;
+                for (const auto &s : decodedEntities) row[s.id] = tick;
+            }
+            // Sample staleness of the near band once the accumulators have warmed up
+            if (t >= 30 && t % 10 == 0) {
+                for (int c = 0; c < clients; c++) {
+                    const uint32_t *row = received.data() + size_t(c) * clients;
+                    for (int e = 0; e < clients; e++) {
+                        float dx = world.posX[e] - world.posX[c], dy = world.posY[e] - world.posY[c];
+                        if (e != c && dx * dx + dy * dy <= nearSq) nearAges.push_back(world.tick - row[e]);
+                    }
+                }
+            }
+        }
+
+        std::vector<double> perClientKBs;
+        uint64_t lost = 0, sentEvents = 0;
+        for (int c = 0; c < clients; c++) {
+            const ClientStats &stats = interest.getStats(c);
+            perClientKBs.push_back(stats.bytesSent * double(kTickRate) / ticks / 1024.0);
+            lost += stats.eventsDropped;
+            sentEvents += stats.eventsSent;
+        }
+        double mean = 0.0;
+        for (double v : perClientKBs) mean += v;
+        mean /= clients;
+
+        double broadcast = (ReplicationPacket::kHeaderBytes + clients * ReplicationPacket::kEntityBytes) * double(kTickRate) / 1024.0;
+        double json = clients * kJsonBytesPerPlayer * double(kTickRate) / 1024.0;
+        double nearAge = 0.0;
+        for (double a : nearAges) nearAge += a;
+        if (!nearAges.empty()) nearAge /= nearAges.size();
+
+        std::printf("%7d %12.2f %12.2f %12.3f %14.2f %14.2f %11.2f %5llu/%llu\n", clients, mean,
+                    percentile(perClientKBs, 95), updateMs / ticks, broadcast, json, nearAge,
+                    (unsigned long long) lost, (unsigned long long) (lost + sentEvents));
+    }
+    std::printf("near age: mean ticks since the last update of entities within %.0f units\n", InterestConfig().bands[0].radius);
+    return 0;
+}
@@ -0,0 +1,113 @@
+// Scaling of the movement and collision passes on the job system, 1 to N worker threads.
+//
+//   JobSystemBench [--quick] [--entities N] [--ticks T] [--max-threads N] [--pin]
+//
+// Each tick runs move -> grid build -> separate -> apply. Move, separate and apply are parallel
+// stages chained with dependency counters; the grid build runs on the calling thread between
+// them, as it is a single counting sort.
+
+#include <cmath>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "BenchUtil.h"
+#include "JobSystem.h"
+#include "Physics.h"
+
+struct TickContext {
+    float halfExtent;
+    World *world;
+    SpatialGrid *grid;
+    std::vector<float> *nextX;
+    std::vector<float> *nextY;
+};
+
+static void moveJob(void *context, int begin, int end) {
+    auto *c = static_cast<TickContext *>(context);
+    Physics::move(*c->world, begin, end, kTickSeconds, c->halfExtent);
+}
+
+static void separateJob(void *context, int begin, int end) {
+    auto *c = static_cast<TickContext *>(context);
+    Physics::separate(*c->world, *c->grid, begin, end, c->nextX->data(), c->nextY->data());
+}
+
+static void applyJob(void *context, int begin, int end) {
+    auto *c = static_cast<TickContext *>(context);
+    std::copy(c->nextX->begin() + begin, c->nextX->begin() + end, c->world->posX.begin() + begin);
+    std::copy(c->nextY->begin() + begin, c->nextY->begin() + end, c->world->posY.begin() + begin);
+}
+
+// The arena grows with the entity count to keep about one player per two square units
+static float arenaHalfExtent(int entities) { return 0.5f * std::sqrt(2.0f * entities); }
+
+static World makeWorld(int entities) {
+    World world;
+    BenchRandom rng(3);
+    const float half = arenaHalfExtent(entities);
+    for (int i = 0; i < entities; i++) {
+        world.add(rng.uniform(-half, half), rng.uniform(-half, half));
+        world.velX[i] = rng.uniform(-1.0f, 1.0f);
+        world.velY[i] = rng.uniform(-1.0f, 1.0f);
+    }
+    return world;
+}
+
+int main(int argc, char **argv) {
+    const bool quick = hasFlag(argc, argv, "--quick");
+    const int entities = optionInt(argc, argv, "--entities", quick ? 20000 : 200000);
+    const int ticks = optionInt(argc, argv, "--ticks", quick ? 10 : 60);
+    const int cores = std::max(1, (int) std::thread::hardware_concurrency());
+    const int maxThreads = optionInt(argc, argv, "--max-threads", quick ? std::min(cores, 4) : cores);
+    const int grain = 2048;
+
+    std::printf("%d entities, %d ticks, %d hardware threads\n", entities, ticks, cores);
+    std::printf("%7s %5s %10s %12s %12s %10s %8s\n", "threads", "big", "move ms", "separate ms", "tick ms", "speedup", "check");
+
+    double baseTick = 0.0;
+    double baseChecksum = 0.0;
+    for (int threads = 1; threads <= maxThreads; threads++) {
+        JobSystemConfig config;
+        config.threads = threads;
+        config.pinThreads = hasFlag(argc, argv, "--pin");
+        JobSystem jobs(config);
+
+        World world = makeWorld(entities);
+        SpatialGrid grid;
+        std::vector<float> nextX(entities), nextY(entities);
+        TickContext context{arenaHalfExtent(entities), &world, &grid, &nextX, &nextY};
+
+        double moveMs = 0.0, separateMs = 0.0, tickMs = 0.0;
+        for (int t = 0; t < ticks; t++) {
+            Stopwatch tick;
+            JobCounter moved;
+            jobs.schedule(moveJob, &context, entities, grain, moved, CoreHint::Big);
+            jobs.wait(moved);
+            moveMs += tick.elapsedMs();
+
+            Stopwatch collide;
+            grid.build(world.posX.data(), world.posY.data(), entities, 2.0f * Physics::kPlayerRadius);
+            JobCounter separated, applied;
+            jobs.schedule(separateJob, &context, entities, grain, separated, CoreHint::Big);
+            jobs.schedule(applyJob, &context, entities, grain, applied, CoreHint::Any, &separated);
+            jobs.wait(applied);
+            separateMs += collide.elapsedMs();
+            tickMs += tick.elapsedMs();
+            world.tick++;
+        }
+
+        // Every thread count must produce the same world
+        double checksum = 0.0;
+        for (int i = 0; i < entities; i++) checksum += world.posX[i] * 0.5 + world.posY[i];
+        if (threads == 1) {
+            baseTick = tickMs;
+            baseChecksum = checksum;
+        }
+        bool same = checksum == baseChecksum;
+        std::printf("%7d %5d %10.3f %12.3f %12.3f %9.2fx %8s\n", threads, jobs.getBigWorkerCount(), moveMs / ticks,
+                    separateMs / ticks, tickMs / ticks, baseTick / tickMs, same ? "ok" : "DIFF");
+        if (!same) return 1;
+    }
+    return 0;
+}
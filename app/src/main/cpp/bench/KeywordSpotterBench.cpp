@@ -0,0 +1,252 @@
+// Streaming keyword spotter benchmark: real-time factor and detection latency.
+//
+//   KeywordSpotterBench [--quick] [--utterances N] [--threshold T]
+//   KeywordSpotterBench --template fireball=fireball.wav ... --input stream.wav --labels stream.txt
+//
+// Without WAV files a synthetic vocabulary of formant sweeps stands in for the spell words;
+// --template is then rejected, as recorded words would never match the synthetic stream. The
+// labels file lists one utterance per line as "<command> <start seconds> <end seconds>".
+// --dump <prefix> writes the synthetic templates and stream as WAV so they can be replayed.
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "BenchUtil.h"
+#include "KeywordSpotter.h"
+#include "SpellType.h"
+#include "WavFile.h"
+
+struct Utterance {
+    int keyword;
+    double start;
+    double end;
+};
+
+static int keywordFromCommand(const std::string &command) {
+    for (int i = 0; i < kSpellTypeCount; i++) {
+        if (command == spellCommand(static_cast<SpellType>(i))) return i;
+    }
+    return -1;
+}
+
+// A voiced sweep through four formant targets, different for every keyword
+static std::vector<float> synthesizeWord(int keyword, int sampleRate, float stretch, float pitch) {
+    BenchRandom spec(keyword + 1);
+    const int segments = 4;
+    float f1[segments + 1], f2[segments + 1], duration[segments];
+    for (int s = 0; s <= segments; s++) {
+        f1[s] = spec.uniform(300.0f, 900.0f);
+        f2[s] = spec.uniform(1000.0f, 2600.0f);
+        if (s < segments) duration[s] = spec.uniform(0.08f, 0.14f) * stretch;
+    }
+    const float f0 = spec.uniform(110.0f, 200.0f) * pitch;
+    const int harmonics = int(4000.0f / f0);
+
+    std::vector<float> out;
+    std::vector<double> phase(harmonics + 1, 0.0);
+    float total = 0.0f;
+    for (float d : duration) total += d;
+    const int totalSamples = int(total * sampleRate);
+    const int ramp = sampleRate / 50;
+
+    int n = 0;
+    for (int s = 0; s < segments; s++) {
+        int count = int(duration[s] * sampleRate);
+        for (int i = 0; i < count; i++, n++) {
+            float t = float(i) / count;
+            float formant1 = f1[s] + (f1[s + 1] - f1[s]) * t;
+            float formant2 = f2[s] + (f2[s + 1] - f2[s]) * t;
+            float sample = 0.0f;
+            for (int h = 1; h <= harmonics; h++) {
+                float freq = h * f0;
+                float a1 = (freq - formant1) / 150.0f;
+                float a2 = (freq - formant2) / 220.0f;
+                float amplitude = std::exp(-a1 * a1) + 0.7f * std::exp(-a2 * a2);
+                phase[h] += 2.0 * M_PI * freq / sampleRate;
+                sample += amplitude * float(std::sin(phase[h]));
+            }
+            float envelope = std::min(1.0f, std::min(float(n) / ramp, float(totalSamples - n) / ramp));
+            out.push_back(0.25f * std::max(0.0f, envelope) * sample);
+        }
+    }
+    return out;
+}
+
+static void appendPcm(std::vector<int16_t> &pcm, const std::vector<float> &samples) {
+    for (float s : samples) {
+        pcm.push_back(int16_t(std::max(-1.0f, std::min(1.0f, s)) * 32767.0f));
+    }
+}
+
+static void buildSynthetic(int sampleRate, int utterances, std::vector<WavData> &templates,
+                           WavData &stream, std::vector<Utterance> &labels) {
+    for (int k = 0; k < kSpellTypeCount; k++) {
+        WavData wav;
+        wav.sampleRate = sampleRate;
+        std::vector<float> silence(sampleRate / 10, 0.0f);
+        appendPcm(wav.samples, silence);
+        appendPcm(wav.samples, synthesizeWord(k, sampleRate, 1.0f, 1.0f));
+        appendPcm(wav.samples, silence);
+        templates.push_back(wav);
+    }
+
+    BenchRandom rng(1234);
+    std::vector<float> audio;
+    auto addNoise = [&](int count) {
+        for (int i = 0; i < count; i++) audio.push_back(rng.uniform(-0.01f, 0.01f));
+    };
+    addNoise(sampleRate / 2);
+    for (int u = 0; u < utterances; u++) {
+        int keyword = u % kSpellTypeCount;
+        std::vector<float> word = synthesizeWord(keyword, sampleRate, rng.uniform(0.9f, 1.1f), rng.uniform(0.95f, 1.05f));
+        Utterance label{keyword, double(audio.size()) / sampleRate, 0.0};
+        for (float s : word) audio.push_back(s + rng.uniform(-0.01f, 0.01f));
+        label.end = double(audio.size()) / sampleRate;
+        labels.push_back(label);
+        addNoise(int(rng.uniform(0.3f, 0.8f) * sampleRate));
+    }
+    stream.sampleRate = sampleRate;
+    appendPcm(stream.samples, audio);
+}
+
+static bool loadLabels(const std::string &path, std::vector<Utterance> &labels) {
+    std::ifstream file(path);
+    if (!file) return false;
+    std::string command;
+    Utterance u{};
+    while (file >> command >> u.start >> u.end) {
+        u.keyword = keywordFromCommand(command);
+        if (u.keyword >= 0) labels.push_back(u);
+    }
+    return true;
+}
+
+int main(int argc, char **argv) {
+    const bool quick = hasFlag(argc, argv, "--quick");
+    const int utterances = optionInt(argc, argv, "--utterances", quick ? 25 : 250);
+
+    SpotterConfig config;
+    if (const char *threshold = optionValue(argc, argv, "--threshold")) config.threshold = float(std::atof(threshold));
+    KeywordSpotter spotter(config);
+    const int sampleRate = spotter.getFeatureConfig().sampleRate;
+    const int hop = spotter.getFeatureConfig().hopLength;
+
+    std::vector<WavData> templates;
+    std::vector<int> templateKeywords;
+    WavData stream;
+    std::vector<Utterance> labels;
+
+    for (int i = 1; i + 1 < argc; i++) {
+        if (std::string(argv[i]) != "--template") continue;
+        std::string spec = argv[i + 1];
+        size_t eq = spec.find('=');
+        int keyword = eq == std::string::npos ? -1 : keywordFromCommand(spec.substr(0, eq));
+        WavData wav;
+        if (keyword < 0 || !WavFile::load(spec.substr(eq + 1), wav)) {
+            std::fprintf(stderr, "bad template %s\n", spec.c_str());
+            return 1;
+        }
+        WavFile::resample(wav, sampleRate);
+        templates.push_back(wav);
+        templateKeywords.push_back(keyword);
+    }
+
+    const char *input = optionValue(argc, argv, "--input");
+    if (input) {
+        if (!WavFile::load(input, stream)) {
+            std::fprintf(stderr, "cannot read %s\n", input);
+            return 1;
+        }
+        WavFile::resample(stream, sampleRate);
+        const char *labelPath = optionValue(argc, argv, "--labels");
+        if (labelPath && !loadLabels(labelPath, labels)) {
+            std::fprintf(stderr, "cannot read %s\n", labelPath);
+            return 1;
+        }
+    } else {
+        // The synthetic stream only contains the synthetic words, recorded templates cannot match it
+        if (!templates.empty()) {
+            std::fprintf(stderr, "--template needs --input: the synthetic stream only matches synthetic templates\n");
+            return 1;
+        }
+        buildSynthetic(sampleRate, utterances, templates, stream, labels);
+        for (int k = 0; k < kSpellTypeCount; k++) templateKeywords.push_back(k);
+
+        if (const char *prefix = optionValue(argc, argv, "--dump")) {
+            for (int k = 0; k < kSpellTypeCount; k++) {
+                WavFile::save(std::string(prefix) + spellCommand(static_cast<SpellType>(k)) + ".wav", templates[k]);
+            }
+            WavFile::save(std::string(prefix) + "stream.wav", stream);
+            std::ofstream labelFile(std::string(prefix) + "stream.txt");
+            for (const auto &u : labels) {
+                labelFile << spellCommand(static_cast<SpellType>(u.keyword)) << " " << u.start << " " << u.end << "\n";
+            }
+        }
+    }
+
+    for (size_t i = 0; i < templates.size(); i++) {
+        if (!spotter.addTemplate(templateKeywords[i], templates[i].samples.data(), int(templates[i].samples.size()))) {
+            std::fprintf(stderr, "template %zu holds no usable speech\n", i);
+            return 1;
+        }
+    }
+
+    // Stream in 10 ms chunks, as the AudioRecord loop does on device
+    std::vector<KeywordDetection> detections;
+    std::vector<double> chunkMs;
+    Stopwatch total;
+    for (size_t offset = 0; offset < stream.samples.size(); offset += hop) {
+        int count = int(std::min<size_t>(hop, stream.samples.size() - offset));
+        Stopwatch chunk;
+        spotter.process(stream.samples.data() + offset, count, detections);
+        chunkMs.push_back(chunk.elapsedMs());
+    }
+    const double processMs = total.elapsedMs();
+    const double audioMs = 1000.0 * stream.samples.size() / sampleRate;
+
+    // A detection counts for the first unmatched utterance whose span (plus a grace period) holds it
+    const auto &fc = spotter.getFeatureConfig();
+    std::vector<bool> matched(labels.size(), false);
+    std::vector<double> latencyMs;
+    int hits = 0, confusions = 0, falseAlarms = 0;
+    for (const auto &d : detections) {
+        double time = double(d.frame * fc.hopLength + fc.frameLength) / fc.sampleRate;
+        bool assigned = false;
+        for (size_t u = 0; u < labels.size(); u++) {
+            if (matched[u] || time < labels[u].start || time > labels[u].end + 0.5) continue;
+            matched[u] = true;
+            assigned = true;
+            if (labels[u].keyword == d.keyword) {
+                hits++;
+                latencyMs.push_back(1000.0 * (time - labels[u].end));
+            } else {
+                confusions++;
+            }
+            break;
+        }
+        if (!assigned) falseAlarms++;
+    }
+
+    std::printf("audio            %.1f s, %zu templates, %zu utterances\n", audioMs / 1000.0, templates.size(), labels.size());
+    std::printf("real-time factor %.4f (%.1f ms processing)\n", processMs / audioMs, processMs);
+    std::printf("per 10 ms chunk  p50 %.4f ms  p99 %.4f ms  max %.4f ms\n",
+                percentile(chunkMs, 50), percentile(chunkMs, 99), percentile(chunkMs, 100));
+    if (!labels.empty()) {
+        std::printf("detections       hits %d/%zu  confusions %d  false alarms %d\n",
+                    hits, labels.size(), confusions, falseAlarms);
+        std::printf("latency vs word end  p50 %.1f ms  p90 %.1f ms  max %.1f ms\n",
+                    percentile(latencyMs, 50), percentile(latencyMs, 90), percentile(latencyMs, 100));
+    } else {
+        std::printf("detections       %zu (no labels)\n", detections.size());
+    }
+
+    // The synthetic run doubles as a smoke test
+    if (!input && hits < int(labels.size()) * 8 / 10) {
+        std::fprintf(stderr, "synthetic recall too low\n");
+        return 1;
+    }
+    return 0;
+}
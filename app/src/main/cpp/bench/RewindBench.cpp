@@ -0,0 +1,164 @@
+// Lag compensation: recording the per-tick position history and hit tests rewound into it.
+//
+//   RewindBench [--quick] [--entities N] [--depth D] [--queries Q]
+//
+// Wandering players are simulated and recorded every tick, then circle queries of the largest
+// spell radius run around random players at random ticks of the window. Rewound queries are
+// compared with the same queries against the present grid, and with a scan of every recorded
+// position, which also checks they find the same entities. Before that, a lightning cast from a
+// caster 100 ms behind must hit a target that has since walked out of range, and only then.
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "BenchUtil.h"
+#include "Physics.h"
+#include "PositionHistory.h"
+#include "SpellSystem.h"
+
+// Players per square unit, about the crowd of the 50x50 arena with 128 players
+constexpr float kDensity = 0.05f;
+
+// A target runs out of a lightning's reach while the caster's view is 6 ticks (100 ms) old
+static bool checkLightning() {
+    World world;
+    // One caster per attempt, so cooldowns do not get in the way
+    EntityId casters[3] = {world.add(0.0f, 0.0f), world.add(0.0f, -1.0f), world.add(0.0f, 1.0f)};
+    EntityId target = world.add(5.0f, 0.0f);
+    world.tick = 1;
+    const uint32_t window = 12;
+    PositionHistory history(int(window), SpellTable::defaults().getMaxRadius());
+    SpellSystem spells;
+    spells.setHistory(&history, window);
+
+    // The target walks right, 0.5 units per tick
+    for (int t = 0; t < 20; t++) {
+        world.posX[target] += 0.5f;
+        history.record(world);
+        world.tick++;
+    }
+
+    // Aimed where the target was 6 ticks ago, 3 units behind where it is now
+    const uint32_t seen = world.tick - 6;
+    const float aimX = history.getX(seen, target);
+    std::vector<CastResult> results;
+    auto hits = [&](EntityId caster, uint32_t viewTick) {
+        spells.queueCast({caster, SpellType::Lightning, aimX, 0.0f, viewTick});
+        spells.resolve(world, &results);
+        return results[0].status == CastStatus::Cast ? int(results[0].hits) : -1;
+    };
+    const int rewound = hits(casters[0], seen);
+    const int present = hits(casters[1], 0);
+    // Older than the window: tested at its edge, where the target was 3 units short of the aim
+    const int capped = hits(casters[2], seen - 10);
+    return rewound == 1 && present == 0 && capped == 0;
+}
+
+int main(int argc, char **argv) {
+    const bool quick = hasFlag(argc, argv, "--quick");
+    const int queries = optionInt(argc, argv, "--queries", quick ? 20000 : 200000);
+    const char *entitiesOption = optionValue(argc, argv, "--entities");
+    const char *depthOption = optionValue(argc, argv, "--depth");
+    std::vector<int> entityCounts = entitiesOption ? std::vector<int>{std::atoi(entitiesOption)}
+                                                   : (quick ? std::vector<int>{1000, 10000}
+                                                            : std::vector<int>{1000, 10000, 100000});
+    std::vector<int> depths = depthOption ? std::vector<int>{std::atoi(depthOption)}
+                                          : (quick ? std::vector<int>{12} : std::vector<int>{12, 60});
+
+    if (!checkLightning()) {
+        std::fprintf(stderr, "rewound lightning did not hit the target under the cursor\n");
+        return 1;
+    }
+
+    const float radius = SpellTable::defaults().getMaxRadius();
+    std::printf("query radius %.1f, %.2f players per square unit\n", radius, kDensity);
+    std::printf("%8s %6s %10s %10s %11s %11s %9s %8s\n", "entities", "depth", "record us", "history MB",
+                "present ns", "rewind ns", "scan ns", "hits");
+
+    for (int entities : entityCounts) {
+        for (int depth : depths) {
+            const float halfExtent = 0.5f * std::sqrt(entities / kDensity);
+            BenchRandom rng(entities + depth);
+            World world;
+            for (int e = 0; e < entities; e++) {
+                EntityId id = world.add(rng.uniform(-halfExtent, halfExtent), rng.uniform(-halfExtent, halfExtent));
+                world.velX[id] = rng.uniform(-1.0f, 1.0f);
+                world.velY[id] = rng.uniform(-1.0f, 1.0f);
+            }
+
+            // Two windows of ticks, so the ring has wrapped before anything is measured
+            PositionHistory history(depth, radius);
+            double recordMs = 0.0;
+            for (int t = 0; t < 2 * depth; t++) {
+                Physics::move(world, 0, entities, kTickSeconds, halfExtent);
+                Stopwatch recording;
+                history.record(world);
+                recordMs += recording.elapsedMs();
+                world.tick++;
+            }
+            const double recordUs = recordMs * 1000.0 / (2 * depth);
+
+            // Around a random player as it was at a random tick of the window
+            std::vector<uint32_t> qt(queries);
+            std::vector<float> qx(queries), qy(queries);
+            for (int i = 0; i < queries; i++) {
+                qt[i] = history.getNewestTick() - rng.next() % uint32_t(depth);
+                EntityId e = rng.next() % uint32_t(entities);
+                qx[i] = history.getX(qt[i], e) + rng.uniform(-radius, radius);
+                qy[i] = history.getY(qt[i], e) + rng.uniform(-radius, radius);
+            }
+            const float radiusSq = radius * radius;
+            auto inside = [&](int i, float x, float y) {
+                float dx = x - qx[i], dy = y - qy[i];
+                return dx * dx + dy * dy <= radiusSq;
+            };
+
+            SpatialGrid present;
+            present.build(world.posX.data(), world.posY.data(), entities, radius);
+            // Kept so the present queries are not optimised away
+            long presentHits = 0;
+            Stopwatch presentQueries;
+            for (int i = 0; i < queries; i++) {
+                present.queryCircle(qx[i], qy[i], radius, [&](uint32_t, float x, float y) {
+                    presentHits += inside(i, x, y);
+                });
+            }
+            const double presentNs = presentQueries.elapsedMs() * 1e6 / queries;
+
+            std::vector<long> rewindHits(queries, 0);
+            Stopwatch rewindQueries;
+            for (int i = 0; i < queries; i++) {
+                history.queryCircle(qt[i], qx[i], qy[i], radius, [&](uint32_t, float x, float y) {
+                    rewindHits[i] += inside(i, x, y);
+                });
+            }
+            const double rewindNs = rewindQueries.elapsedMs() * 1e6 / queries;
+
+            // Scanning is O(entities) per query: only a sample, which must agree with the grid
+            const int scans = std::max(1, std::min(queries, int(2e8 / entities) / 10));
+            long scanHits = 0, sampledHits = 0;
+            Stopwatch scanning;
+            for (int i = 0; i < scans; i++) {
+                const uint32_t t = qt[i];
+                for (int e = 0; e < history.getEntityCount(t); e++) {
+                    if (history.wasAlive(t, e)) scanHits += inside(i, history.getX(t, e), history.getY(t, e));
+                }
+            }
+            const double scanNs = scanning.elapsedMs() * 1e6 / scans;
+            for (int i = 0; i < scans; i++) sampledHits += rewindHits[i];
+            if (scanHits != sampledHits) {
+                std::fprintf(stderr, "rewound grid and scan disagree: %ld vs %ld hits\n", sampledHits, scanHits);
+                return 1;
+            }
+
+            long totalRewindHits = 0;
+            for (long hits : rewindHits) totalRewindHits += hits;
+            std::printf("%8d %6d %10.1f %10.1f %11.1f %11.1f %9.0f %8.2f\n", entities, depth, recordUs,
+                        history.getByteSize() / 1048576.0, presentNs, rewindNs, scanNs,
+                        double(totalRewindHits) / queries);
+            if (presentHits < 0) return 1;
+        }
+    }
+    return 0;
+}
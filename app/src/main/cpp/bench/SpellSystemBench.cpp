@@ -0,0 +1,203 @@
+// Batched spell resolution with many simultaneous casters.
+//
+//   SpellSystemBench [--quick] [--entities N] [--ticks T]
+//
+// Compares SpellSystem against a baseline shaped like the Kotlin SpellSystem.tryCast: a hash map
+// of "<caster>:<spell>" cooldown keys and a linear scan of every player per cast. First checks
+// that gust knockback respects the arena the caller passes in, and obstacles, that cast targets
+// are pulled back into range from the rewound caster, and that a slow landing after another has
+// expired does not inherit its potency.
+
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "BenchUtil.h"
+#include "Physics.h"
+#include "PositionHistory.h"
+#include "SpellSystem.h"
+
+static World makeWorld(int entities, uint64_t seed) {
+    World world;
+    BenchRandom rng(seed);
+    const float half = kMapSize * 0.5f;
+    for (int i = 0; i < entities; i++) {
+        world.add(rng.uniform(-half, half), rng.uniform(-half, half));
+        world.mana[i] = 1 << 20; // Mana never runs out, every cast is limited by cooldown only
+    }
+    return world;
+}
+
+static std::vector<CastRequest> makeCasts(const World &world, int casters, uint32_t tick, BenchRandom &rng) {
+    std::vector<CastRequest> casts;
+    casts.reserve(casters);
+    for (int i = 0; i < casters; i++) {
+        EntityId caster = rng.next() % world.size();
+        casts.push_back({caster, static_cast<SpellType>((i + tick) % kSpellTypeCount),
+                         world.posX[caster] + rng.uniform(-4.0f, 4.0f),
+                         world.posY[caster] + rng.uniform(-4.0f, 4.0f)});
+    }
+    return casts;
+}
+
+// Per-cast baseline: string cooldown key and a scan of all players
+static int baselineResolve(World &world, const std::vector<CastRequest> &casts,
+                           std::unordered_map<std::string, uint32_t> &cooldowns, const SpellTable &table) {
+    int hits = 0;
+    for (const auto &cast : casts) {
+        const SpellDefinition &def = table.get(cast.spell);
+        std::string key = std::to_string(cast.caster) + ":" + spellCommand(cast.spell);
+        auto it = cooldowns.find(key);
+        if (it != cooldowns.end() && world.tick < it->second) continue;
+        if (world.mana[cast.caster] < def.manaCost) continue;
+        world.mana[cast.caster] -= def.manaCost;
+        cooldowns[key] = world.tick + def.cooldownTicks;
+        if (def.shape == SpellShape::Self) {
+            hits++;
+            continue;
+        }
+        for (int e = 0; e < world.size(); e++) {
+            if (EntityId(e) == cast.caster) continue;
+            float dx = world.posX[e] - cast.targetX;
+            float dy = world.posY[e] - cast.targetY;
+            if (std::sqrt(dx * dx + dy * dy) <= def.radius) {
+                world.hp[e] = std::max(0, world.hp[e] - def.damage);
+                hits++;
+            }
+        }
+    }
+    return hits;
+}
+
+// A weak freeze landing after a strong one has worn off slows by its own potency
+static bool checkSlowExpiry() {
+    World world;
+    EntityId caster = world.add(0.0f, 0.0f);
+    EntityId target = world.add(5.0f, 0.0f);
+    SpellTable strongTable = SpellTable::defaults(), weakTable = SpellTable::defaults();
+    strongTable.get(SpellType::Freeze).magnitude = 0.8f;
+    weakTable.get(SpellType::Freeze).magnitude = 0.3f;
+    SpellSystem strong(strongTable), weak(weakTable);
+    strong.queueCast({caster, SpellType::Freeze, 5.0f, 0.0f});
+    strong.resolve(world);
+    world.tick += strongTable.get(SpellType::Freeze).effectTicks;
+    weak.queueCast({caster, SpellType::Freeze, 5.0f, 0.0f});
+    weak.resolve(world);
+    return std::fabs(world.speedMultiplier(target) - 0.7f) < 1e-6f;
+}
+
+// A fireball aimed 50 units away lands at the edge of its range, measured from where the caster
+// stood on the tick it saw; the caster has walked 4 units right since
+static bool checkCastRange() {
+    World world;
+    EntityId caster = world.add(0.0f, 0.0f);
+    world.tick = 1;
+    PositionHistory history(12, SpellTable::defaults().getMaxRadius());
+    SpellSystem spells;
+    spells.setHistory(&history, 12);
+    for (int t = 0; t < 8; t++) {
+        history.record(world);
+        world.posX[caster] += 0.5f;
+        world.tick++;
+    }
+    const float range = SpellTable::defaults().get(SpellType::Fireball).range;
+    CastRequest present{caster, SpellType::Fireball, 50.0f, 0.0f};
+    spells.clampToRange(world, present);
+    CastRequest rewound{caster, SpellType::Fireball, 50.0f, 0.0f, world.tick - 8};
+    spells.clampToRange(world, rewound);
+    CastRequest near{caster, SpellType::Fireball, 5.0f, 1.0f};
+    spells.clampToRange(world, near);
+    return std::fabs(present.targetX - (4.0f + range)) < 1e-4f && std::fabs(rewound.targetX - range) < 1e-4f &&
+           near.targetX == 5.0f && near.targetY == 1.0f;
+}
+
+// A gust aimed just inside the edge pushes its target 5 units outward
+static bool checkKnockbackBounds() {
+    const float halfExtent = 10.0f;
+    World world;
+    EntityId caster = world.add(0.0f, 0.0f);
+    EntityId target = world.add(halfExtent - 1.0f, 0.0f);
+    SpellSystem spells;
+    spells.queueCast({caster, SpellType::Gust, halfExtent - 2.0f, 0.0f});
+    spells.resolve(world, nullptr, halfExtent);
+    if (world.posX[target] > halfExtent) return false;
+
+    // Wall of rock at tile x = 12 of a 20x20 grid centred on the origin, x in [2, 3]: the target
+    // is pushed toward it from x = 0.5 and must stop on the near side, not tunnel through
+    const float wallLeftEdge = 2.0f;
+    ObstacleGrid obstacles;
+    obstacles.resize(20, 20, 1.0f, -halfExtent, -halfExtent);
+    for (int y = 0; y < 20; y++) obstacles.setBlocked(12, y, true);
+    world.posX[target] = 0.5f;
+    world.posY[target] = 0.0f;
+    world.tick += 1000;
+    spells.queueCast({caster, SpellType::Gust, -0.5f, 0.0f});
+    spells.resolve(world, obstacles);
+    return world.posX[target] > 0.5f && world.posX[target] <= wallLeftEdge - Physics::kPlayerRadius &&
+           !obstacles.overlaps(world.posX[target], world.posY[target], Physics::kPlayerRadius);
+}
+
+int main(int argc, char **argv) {
+    if (!checkKnockbackBounds()) {
+        std::fprintf(stderr, "knockback left the arena or crossed an obstacle\n");
+        return 1;
+    }
+    if (!checkCastRange()) {
+        std::fprintf(stderr, "a cast target beyond the spell's range was not pulled back to it\n");
+        return 1;
+    }
+    if (!checkSlowExpiry()) {
+        std::fprintf(stderr, "a new slow kept the potency of one that had expired\n");
+        return 1;
+    }
+
+    const bool quick = hasFlag(argc, argv, "--quick");
+    const int entities = optionInt(argc, argv, "--entities", quick ? 500 : 5000);
+    const int ticks = optionInt(argc, argv, "--ticks", quick ? 20 : 120);
+    const SpellTable &table = SpellTable::defaults();
+
+    std::printf("%d entities, %d ticks\n", entities, ticks);
+    std::printf("%10s %16s %16s %10s\n", "casts/tick", "batched ns/cast", "baseline ns/cast", "speedup");
+
+    for (int castsPerTick : {entities / 100, entities / 10, entities / 2, entities}) {
+        if (castsPerTick <= 0) continue;
+        World batchedWorld = makeWorld(entities, 7);
+        World baselineWorld = makeWorld(entities, 7);
+        SpellSystem spells(table);
+        std::unordered_map<std::string, uint32_t> cooldowns;
+        std::vector<CastResult> results;
+
+        double batchedMs = 0.0, baselineMs = 0.0;
+        long castCount = 0, accepted = 0;
+        BenchRandom rng(99);
+        for (int t = 0; t < ticks; t++) {
+            std::vector<CastRequest> casts = makeCasts(batchedWorld, castsPerTick, t, rng);
+
+            Stopwatch batched;
+            for (const auto &cast : casts) spells.queueCast(cast);
+            spells.resolve(batchedWorld, &results);
+            batchedMs += batched.elapsedMs();
+
+            Stopwatch baseline;
+            baselineResolve(baselineWorld, casts, cooldowns, table);
+            baselineMs += baseline.elapsedMs();
+
+            for (const auto &r : results) accepted += r.status == CastStatus::Cast;
+            castCount += (long) casts.size();
+            batchedWorld.tick++;
+            baselineWorld.tick++;
+            // Keep everyone alive so the hit workload stays constant
+            std::fill(batchedWorld.hp.begin(), batchedWorld.hp.end(), kMaxHp);
+            std::fill(batchedWorld.alive.begin(), batchedWorld.alive.end(), 1);
+            std::fill(baselineWorld.hp.begin(), baselineWorld.hp.end(), kMaxHp);
+        }
+
+        double batchedNs = batchedMs * 1e6 / castCount;
+        double baselineNs = baselineMs * 1e6 / castCount;
+        std::printf("%10d %16.1f %16.1f %9.1fx   (%ld accepted)\n",
+                    castsPerTick, batchedNs, baselineNs, baselineNs / batchedNs, accepted);
+    }
+    return 0;
+}
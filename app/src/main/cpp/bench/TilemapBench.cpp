@@ -0,0 +1,155 @@
+// Chunked tilemap on large maps: chunk baking, view culling and obstacle collision.
+//
+//   TilemapBench [--quick] [--entities N] [--ticks T] [--frames F]
+//
+// Baking reports the cost and size of the static geometry a chunk uploads once. Culling pans a
+// phone-sized orthographic view across the map and counts the draw calls per frame with one call
+// per visible chunk, against one call per visible tile. Collision compares the bitset obstacle grid with
+// looking up each tile in the chunked tile storage, then moves players with Physics::move and
+// checks none of them ends up inside a rock. Before that, moves longer than a tile toward a
+// one tile thick wall must stop in front of it on each axis.
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "BenchUtil.h"
+#include "Physics.h"
+#include "Tilemap.h"
+
+// Default orthographic view: kProjectionHalfHeight 10 at a 20:9 aspect ratio
+constexpr float kViewHalfHeight = 10.0f;
+constexpr float kViewHalfWidth = kViewHalfHeight * 20.0f / 9.0f;
+
+// Baseline overlap test: one tile lookup per covered tile
+static bool overlapsByTile(const Tilemap &map, float x, float y, float halfSize) {
+    const float originX = -0.5f * map.getWidth(), originY = -0.5f * map.getHeight();
+    int x0 = (int) std::floor(x - halfSize - originX), x1 = (int) std::floor(x + halfSize - originX);
+    int y0 = (int) std::floor(y - halfSize - originY), y1 = (int) std::floor(y + halfSize - originY);
+    if (x0 < 0 || y0 < 0 || x1 >= map.getWidth() || y1 >= map.getHeight()) return true;
+    for (int ty = y0; ty <= y1; ty++) {
+        for (int tx = x0; tx <= x1; tx++) {
+            if (isSolid(map.getTile(tx, ty))) return true;
+        }
+    }
+    return false;
+}
+
+// Five unit moves from either side of a column and a row of rock one tile thick
+static bool checkThinWalls() {
+    ObstacleGrid obstacles;
+    obstacles.resize(8, 8, 1.0f, 0.0f, 0.0f);
+    for (int i = 0; i < 8; i++) {
+        obstacles.setBlocked(3, i, true);
+        obstacles.setBlocked(i, 3, true);
+    }
+    const float h = Physics::kPlayerRadius;
+    for (float push : {5.0f, -5.0f}) {
+        const float from = push > 0.0f ? 0.5f + h : 7.5f - h;
+        float x = from, y = 1.5f;
+        obstacles.slide(x, y, push, 0.0f, h);
+        float u = 1.5f, v = from;
+        obstacles.slide(u, v, 0.0f, push, h);
+        // Flush against the near side, never past the wall
+        const bool nearX = push > 0.0f ? x <= 3.0f - h && x > 2.9f - h : x >= 4.0f + h && x < 4.1f + h;
+        const bool nearY = push > 0.0f ? v <= 3.0f - h && v > 2.9f - h : v >= 4.0f + h && v < 4.1f + h;
+        if (!nearX || !nearY || obstacles.overlaps(x, y, h) || obstacles.overlaps(u, v, h)) return false;
+    }
+    return true;
+}
+
+int main(int argc, char **argv) {
+    if (!checkThinWalls()) {
+        std::fprintf(stderr, "a long move went through a wall one tile thick\n");
+        return 1;
+    }
+
+    const bool quick = hasFlag(argc, argv, "--quick");
+    const int entities = optionInt(argc, argv, "--entities", quick ? 5000 : 50000);
+    const int ticks = optionInt(argc, argv, "--ticks", quick ? 30 : 300);
+    const int frames = optionInt(argc, argv, "--frames", quick ? 200 : 2000);
+    std::vector<int> sizes = quick ? std::vector<int>{256, 1024} : std::vector<int>{1024, 4096, 8192};
+
+    std::printf("view %.1f x %.1f units, %d x %d tile chunks\n", 2 * kViewHalfWidth, 2 * kViewHalfHeight,
+                Tilemap::kChunkTiles, Tilemap::kChunkTiles);
+    std::printf("%6s %8s %9s %10s %9s %10s %10s %9s %10s %10s %9s %9s\n", "map", "chunks", "bake us", "chunk KB",
+                "cull us", "chunk draw", "tile draw", "bits KB", "tiles KB", "bits ns", "tile ns", "move ns");
+
+    for (int size : sizes) {
+        Tilemap map = Tilemap::makeArena(size, size, 0.15f, 7);
+
+        // Bake every chunk, as the renderer does the first time each one is visible
+        Stopwatch baking;
+        ChunkMesh mesh;
+        size_t geometryBytes = 0;
+        for (int c = 0; c < map.getChunkCount(); c++) {
+            map.bakeChunk(c, mesh);
+            geometryBytes += mesh.vertices.size() * sizeof(Vertex) + mesh.indices.size() * sizeof(uint16_t);
+        }
+        const double bakeUs = baking.elapsedMs() * 1000.0 / map.getChunkCount();
+
+        // Pan the view diagonally across the whole map
+        std::vector<int> visible;
+        double chunkDraws = 0.0;
+        Stopwatch culling;
+        for (int f = 0; f < frames; f++) {
+            float t = float(f) / float(frames);
+            float cx = (t - 0.5f) * size * 0.9f, cy = (0.5f - t) * size * 0.9f;
+            map.findVisibleChunks(cx - kViewHalfWidth, cy - kViewHalfHeight, cx + kViewHalfWidth,
+                                  cy + kViewHalfHeight, visible);
+            chunkDraws += visible.size();
+        }
+        const double cullUs = culling.elapsedMs() * 1000.0 / frames;
+        const double tileDraws = (2 * kViewHalfWidth + 1) * (2 * kViewHalfHeight + 1);
+
+        // Overlap queries at random points, bitset against tile lookups; both must agree
+        BenchRandom rng(size);
+        const int queries = entities * 20;
+        std::vector<float> qx(queries), qy(queries);
+        for (int i = 0; i < queries; i++) {
+            qx[i] = rng.uniform(-0.5f * size, 0.5f * size);
+            qy[i] = rng.uniform(-0.5f * size, 0.5f * size);
+        }
+        const ObstacleGrid &obstacles = map.getObstacles();
+        int bitHits = 0, tileHits = 0;
+        Stopwatch bits;
+        for (int i = 0; i < queries; i++) bitHits += obstacles.overlaps(qx[i], qy[i], Physics::kPlayerRadius);
+        const double bitsNs = bits.elapsedMs() * 1e6 / queries;
+        Stopwatch tiles;
+        for (int i = 0; i < queries; i++) tileHits += overlapsByTile(map, qx[i], qy[i], Physics::kPlayerRadius);
+        const double tilesNs = tiles.elapsedMs() * 1e6 / queries;
+        if (bitHits != tileHits) {
+            std::fprintf(stderr, "bitset and tile lookups disagree: %d vs %d\n", bitHits, tileHits);
+            return 1;
+        }
+
+        // Wandering players spawned on free ground
+        World world;
+        while (world.size() < entities) {
+            float x = rng.uniform(-0.5f * size, 0.5f * size), y = rng.uniform(-0.5f * size, 0.5f * size);
+            if (obstacles.overlaps(x, y, Physics::kPlayerRadius)) continue;
+            EntityId e = world.add(x, y);
+            world.velX[e] = rng.uniform(-1.0f, 1.0f);
+            world.velY[e] = rng.uniform(-1.0f, 1.0f);
+        }
+        Stopwatch moving;
+        for (int t = 0; t < ticks; t++) {
+            Physics::move(world, 0, entities, kTickSeconds, obstacles);
+            world.tick++;
+        }
+        const double moveNs = moving.elapsedMs() * 1e6 / (double(ticks) * entities);
+        for (int e = 0; e < entities; e++) {
+            if (obstacles.overlaps(world.posX[e], world.posY[e], Physics::kPlayerRadius)) {
+                std::fprintf(stderr, "entity %d ended inside an obstacle\n", e);
+                return 1;
+            }
+        }
+
+        const double tileBytes = double(map.getWidth()) * map.getHeight() * sizeof(TileType);
+        std::printf("%6d %8d %9.1f %10.1f %9.3f %10.1f %10.0f %9.1f %10.1f %10.2f %9.2f %9.2f\n", size,
+                    map.getChunkCount(), bakeUs, geometryBytes / 1024.0 / map.getChunkCount(), cullUs,
+                    chunkDraws / frames, tileDraws, obstacles.getByteSize() / 1024.0, tileBytes / 1024.0, bitsNs,
+                    tilesNs, moveNs);
+    }
+    return 0;
+}
@@ -8,6 +8,8 @@
 #include "AndroidOut.h"
 #include "Renderer.h"
 #include "Model.h" // Corrected include
+#include "KeywordSpotter.h"
+#include "WavFile.h"
 
 #define LOG_TAG "MageVoiceNative"
 #define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
@@ -15,22 +17,27 @@
 
 // --- Global State ---
 static const char* LOCAL_PLAYER_ID = "local_player";
+// Lives until the activity finishes, across surface and activity recreation
 static Renderer* g_renderer = nullptr;
 static Model g_model; // Use the correct Model struct
 static std::atomic<bool> g_rendering(false);
 static std::thread g_render_thread;
 static std::mutex g_model_mutex; // Mutex to protect access to g_model
+static ANativeWindow* g_window = nullptr;
 
 // --- Render Loop ---
-void render_loop() {
+// Owns the GL context while it runs: attaches the window on start and detaches it on exit
+void render_loop(ANativeWindow* window) {
     LOGI("render_loop() started");
+    if (!g_renderer->attachWindow(window)) {
+        LOGE("Renderer::attachWindow failed");
+        return;
+    }
     while (g_rendering) {
         try {
-            if (g_renderer) {
-                std::lock_guard<std::mutex> lock(g_model_mutex);
-                g_renderer->update(g_model);
-                g_renderer->render(g_model);
-            }
+            std::lock_guard<std::mutex> lock(g_model_mutex);
+            g_renderer->update(g_model);
+            g_renderer->render(g_model);
         } catch (const std::exception& e) {
             LOGE("Exception in render_loop: %s", e.what());
         } catch (...) {
@@ -38,9 +45,24 @@ void render_loop() {
         }
         std::this_thread::sleep_for(std::chrono::milliseconds(16));
     }
+    g_renderer->detachWindow();
     LOGI("render_loop() finished");
 }
 
+// Stops rendering and lets go of the window; the renderer keeps its context
+static void release_surface() {
+    g_rendering = false;
+    if (g_render_thread.joinable()) {
+        LOGI("Joining render thread");
+        g_render_thread.join();
+        LOGI("Render thread joined");
+    }
+    if (g_window) {
+        ANativeWindow_release(g_window);
+        g_window = nullptr;
+    }
+}
+
 // --- JNI Bridge Implementation ---
 extern "C" {
 
@@ -50,31 +72,34 @@ Java_com_game_voicespells_presentation_activities_GameActivity_initNative(
         jobject /* this */,
         jobject surface) {
     LOGI("JNI initNative() called");
-    if (g_renderer) {
-        LOGI("Deleting existing renderer");
-        delete g_renderer;
-        g_renderer = nullptr;
+    // surfaceDestroyed normally did this already
+    release_surface();
+
+    if (!g_renderer) {
+        LOGI("Creating renderer");
+        g_renderer = new Renderer();
+        g_renderer->setLocalPlayer(LOCAL_PLAYER_ID);
     }
+    g_renderer->beginResume();
 
-    ANativeWindow *window = ANativeWindow_fromSurface(env, surface);
-    if (window) {
+    g_window = ANativeWindow_fromSurface(env, surface);
+    if (g_window) {
         LOGI("ANativeWindow created successfully");
-        g_renderer = new Renderer();
-        g_renderer->init(window);
-        ANativeWindow_release(window);
 
-        // Initialize the game model with a local player
+        // The local player survives surface and activity recreation, only add it once
         {
             std::lock_guard<std::mutex> lock(g_model_mutex);
-            PlayerState local_player;
-            local_player.position = {0.0f, 0.0f};
-            local_player.velocity = {0.0f, 0.0f};
-            g_model.players[LOCAL_PLAYER_ID] = local_player;
-            LOGI("Local player initialized in the model");
+            if (g_model.players.find(LOCAL_PLAYER_ID) == g_model.players.end()) {
+                PlayerState local_player;
+                local_player.position = {0.0f, 0.0f};
+                local_player.velocity = {0.0f, 0.0f};
+                g_model.players[LOCAL_PLAYER_ID] = local_player;
+                LOGI("Local player initialized in the model");
+            }
         }
 
         g_rendering = true;
-        g_render_thread = std::thread(render_loop);
+        g_render_thread = std::thread(render_loop, g_window);
         LOGI("Render thread started");
     } else {
         LOGE("Failed to create ANativeWindow");
@@ -82,6 +107,14 @@ Java_com_game_voicespells_presentation_activities_GameActivity_initNative(
     LOGI("JNI initNative() finished\n");
 }
 
+JNIEXPORT void JNICALL
+Java_com_game_voicespells_presentation_activities_GameActivity_releaseSurfaceNative(
+        JNIEnv *env,
+        jobject /* this */) {
+    LOGI("JNI releaseSurfaceNative() called");
+    release_surface();
+}
+
 JNIEXPORT void JNICALL
 Java_com_game_voicespells_presentation_activities_GameActivity_onJoystickMovedNative(
         JNIEnv *env,
@@ -100,13 +133,15 @@ Java_com_game_voicespells_presentation_activities_GameActivity_onJoystickMovedNa
 JNIEXPORT void JNICALL
 Java_com_game_voicespells_presentation_activities_GameActivity_cleanupNative(
         JNIEnv *env,
-        jobject /* this */) {
-    LOGI("JNI cleanupNative() called");
-    g_rendering = false;
-    if (g_render_thread.joinable()) {
-        LOGI("Joining render thread");
-        g_render_thread.join();
-        LOGI("Render thread joined");
+        jobject /* this */,
+        jboolean finishing) {
+    LOGI("JNI cleanupNative() called, finishing = %d", finishing);
+    release_surface();
+
+    // A configuration change (rotation) recreates the activity: keep the context and the match
+    if (!finishing) {
+        LOGI("JNI cleanupNative() finished, renderer and model kept");
+        return;
     }
 
     if (g_renderer) {
@@ -149,4 +184,76 @@ Java_com_game_voicespells_presentation_activities_GameActivity_updatePlayerState
 }
 
 
-} // extern "C"
\ No newline at end of file
+// --- Streaming keyword spotter (com.game.voicespells.core.voice.NativeKeywordSpotter) ---
+
+JNIEXPORT jlong JNICALL
+Java_com_game_voicespells_core_voice_NativeKeywordSpotter_nativeCreate(
+        JNIEnv *env,
+        jobject /* this */) {
+    return reinterpret_cast<jlong>(new KeywordSpotter());
+}
+
+JNIEXPORT void JNICALL
+Java_com_game_voicespells_core_voice_NativeKeywordSpotter_nativeDestroy(
+        JNIEnv *env,
+        jobject /* this */,
+        jlong handle) {
+    delete reinterpret_cast<KeywordSpotter*>(handle);
+}
+
+// Enrolls a WAV recording of a spell word; keyword is the SpellType ordinal
+JNIEXPORT jboolean JNICALL
+Java_com_game_voicespells_core_voice_NativeKeywordSpotter_nativeAddTemplateWav(
+        JNIEnv *env,
+        jobject /* this */,
+        jlong handle,
+        jint keyword,
+        jbyteArray wavBytes) {
+    auto* spotter = reinterpret_cast<KeywordSpotter*>(handle);
+    jsize size = env->GetArrayLength(wavBytes);
+    jbyte* bytes = env->GetByteArrayElements(wavBytes, nullptr);
+
+    WavData wav;
+    bool ok = WavFile::parse(reinterpret_cast<const uint8_t*>(bytes), size_t(size), wav);
+    env->ReleaseByteArrayElements(wavBytes, bytes, JNI_ABORT);
+    if (!ok) {
+        LOGE("Keyword template %d is not a 16-bit PCM WAV", keyword);
+        return JNI_FALSE;
+    }
+
+    WavFile::resample(wav, spotter->getFeatureConfig().sampleRate);
+    ok = spotter->addTemplate(keyword, wav.samples.data(), int(wav.samples.size()));
+    if (!ok) LOGE("Keyword template %d holds no usable speech", keyword);
+    return ok ? JNI_TRUE : JNI_FALSE;
+}
+
+// Feeds microphone PCM; returns the SpellType ordinal of the first detection, or -1
+JNIEXPORT jint JNICALL
+Java_com_game_voicespells_core_voice_NativeKeywordSpotter_nativeProcess(
+        JNIEnv *env,
+        jobject /* this */,
+        jlong handle,
+        jshortArray pcm,
+        jint count) {
+    auto* spotter = reinterpret_cast<KeywordSpotter*>(handle);
+    static thread_local std::vector<KeywordDetection> detections;
+    detections.clear();
+
+    jshort* samples = static_cast<jshort*>(env->GetPrimitiveArrayCritical(pcm, nullptr));
+    spotter->process(samples, count, detections);
+    env->ReleasePrimitiveArrayCritical(pcm, samples, JNI_ABORT);
+
+    if (detections.empty()) return -1;
+    LOGI("Keyword %d detected, confidence %.2f", detections[0].keyword, detections[0].confidence);
+    return detections[0].keyword;
+}
+
+JNIEXPORT void JNICALL
+Java_com_game_voicespells_core_voice_NativeKeywordSpotter_nativeReset(
+        JNIEnv *env,
+        jobject /* this */,
+        jlong handle) {
+    reinterpret_cast<KeywordSpotter*>(handle)->reset();
+}
+
+} // extern "C"
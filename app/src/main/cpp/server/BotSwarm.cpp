@@ -0,0 +1,153 @@
+#include "BotSwarm.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+#include "WireFormat.h"
+
+// Bots steer back toward the centre beyond this distance from it
+constexpr float kWanderRadius = kArenaTiles * 0.4f;
+
+BotSwarm::BotSwarm(const NetAddress &server, const BotConfig &config)
+        : server_(server), config_(config), buffer_(WireFormat::kMaxDatagramBytes) {}
+
+BotSwarm::~BotSwarm() { stop(); }
+
+void BotSwarm::start() {
+    if (running_) return;
+    running_ = true;
+    thread_ = std::thread([this] { run(); });
+}
+
+void BotSwarm::stop() {
+    running_ = false;
+    if (thread_.joinable()) thread_.join();
+    target_ = 0;
+    resize();
+}
+
+void BotSwarm::run() {
+    const auto period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(1.0 / config_.tickRate));
+    auto next = std::chrono::steady_clock::now();
+    while (running_) {
+        resize();
+        for (auto &bot : bots_) {
+            receive(*bot);
+            sendInput(*bot);
+        }
+        tick_++;
+
+        next += period;
+        auto now = std::chrono::steady_clock::now();
+        // Behind by more than a tick (overloaded host): skip ahead instead of bursting
+        if (now > next + period) next = now;
+        std::this_thread::sleep_until(next);
+    }
+}
+
+void BotSwarm::resize() {
+    const int target = target_;
+    while ((int) bots_.size() > target) {
+        Bot &bot = *bots_.back();
+        NetMessage::writeLeave(message_);
+        bot.socket.sendTo(server_, message_.data(), message_.size());
+        if (bot.welcomed) welcomed_--;
+        bots_.pop_back();
+    }
+    while ((int) bots_.size() < target) {
+        auto bot = std::make_unique<Bot>();
+        if (!bot->socket.open(0)) break;
+        bot->rng = BenchRandom(config_.seed * 1000003 + spawned_++);
+        bot->heading = bot->rng.uniform(0.0f, 6.2831853f);
+        bot->nextCastTick = tick_ + uint32_t(bot->rng.uniform(0.0f, 1.0f / config_.castsPerSecond) * config_.tickRate);
+        bots_.push_back(std::move(bot));
+    }
+}
+
+void BotSwarm::receive(Bot &bot) {
+    NetAddress from;
+    int size;
+    while ((size = bot.socket.receiveFrom(buffer_.data(), buffer_.size(), from)) >= 0) {
+        if (size == 0) continue;
+        const uint8_t *data = buffer_.data();
+        switch (static_cast<NetMessageType>(NetMessage::type(data, size))) {
+            case NetMessageType::Welcome: {
+                uint32_t tick;
+                if (!bot.welcomed && NetMessage::readWelcome(data, size, bot.entity, tick)) {
+                    bot.welcomed = true;
+                    welcomed_++;
+                }
+                break;
+            }
+            case NetMessageType::State: {
+                uint32_t tick;
+                if (!ReplicationPacket::read(data + 1, size - 1, tick, events_, entities_)) break;
+                statesReceived_.fetch_add(1, std::memory_order_relaxed);
+                bot.viewTick = std::max(bot.viewTick, tick);
+                // The own entity is always present; aim at the closest other live player
+                float bestSq = std::numeric_limits<float>::max();
+                bot.hasTarget = false;
+                for (const EntitySnapshot &e : entities_) {
+                    if (e.id == bot.entity) {
+                        bot.x = e.x;
+                        bot.y = e.y;
+                    }
+                }
+                for (const EntitySnapshot &e : entities_) {
+                    if (e.id == bot.entity || e.hp == 0) continue;
+                    float dx = e.x - bot.x, dy = e.y - bot.y;
+                    if (dx * dx + dy * dy < bestSq) {
+                        bestSq = dx * dx + dy * dy;
+                        bot.hasTarget = true;
+                        bot.targetX = e.x;
+                        bot.targetY = e.y;
+                    }
+                }
+                break;
+            }
+            default:
+                break;
+        }
+    }
+}
+
+void BotSwarm::sendInput(Bot &bot) {
+    if (!bot.welcomed) {
+        // Join, retried once a second until the server answers
+        if (bot.sequence++ % uint32_t(config_.tickRate) == 0) {
+            NetMessage::writeJoin(message_);
+            bot.socket.sendTo(server_, message_.data(), message_.size());
+        }
+        return;
+    }
+
+    // Wander: a turn rate that changes every second or two, pulled back inward near the edge
+    if (tick_ >= bot.nextTurnTick) {
+        bot.turnRate = bot.rng.uniform(-2.0f, 2.0f);
+        bot.nextTurnTick = tick_ + uint32_t(bot.rng.uniform(1.0f, 2.0f) * config_.tickRate);
+    }
+    bot.heading += bot.turnRate / config_.tickRate;
+    if (bot.x * bot.x + bot.y * bot.y > kWanderRadius * kWanderRadius) {
+        bot.heading = std::atan2(-bot.y, -bot.x);
+    }
+
+    ClientInput input;
+    input.sequence = ++bot.sequence;
+    input.moveX = std::cos(bot.heading);
+    input.moveY = std::sin(bot.heading);
+    if (tick_ >= bot.nextCastTick) {
+        // Exponential gaps give the configured average rate without casts lining up across bots
+        float gapSeconds = -std::log(1.0f - bot.rng.uniform(0.0f, 0.999f)) / config_.castsPerSecond;
+        bot.nextCastTick = tick_ + std::max(1u, uint32_t(gapSeconds * config_.tickRate));
+        input.spell = static_cast<SpellType>(bot.rng.next() % kSpellTypeCount);
+        input.targetX = bot.hasTarget ? bot.targetX : bot.x + 3.0f * input.moveX;
+        input.targetY = bot.hasTarget ? bot.targetY : bot.y + 3.0f * input.moveY;
+        input.viewTick = bot.viewTick;
+        castsSent_.fetch_add(1, std::memory_order_relaxed);
+    }
+    NetMessage::writeInput(message_, input);
+    bot.socket.sendTo(server_, message_.data(), message_.size());
+}
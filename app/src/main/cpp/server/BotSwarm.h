@@ -0,0 +1,90 @@
+#ifndef MAGEVOICE_BOTSWARM_H
+#define MAGEVOICE_BOTSWARM_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "BenchUtil.h"
+#include "NetMessage.h"
+#include "ReplicationPacket.h"
+#include "UdpSocket.h"
+
+struct BotConfig {
+    int tickRate = kTickRate;
+    // Average spell casts per bot per second
+    float castsPerSecond = 0.5f;
+    uint64_t seed = 1;
+};
+
+/*!
+ * Simulated clients for load testing a GameServer, all driven by one thread.
+ *
+ * Every bot has its own UDP socket, so the server sees one endpoint per player. Bots send one
+ * input per tick: a wandering joystick that steers back toward the centre near the arena edge,
+ * and now and then a random spell aimed at the nearest player in the last state they decoded.
+ */
+class BotSwarm {
+public:
+    BotSwarm(const NetAddress &server, const BotConfig &config);
+    ~BotSwarm();
+
+    void start();
+    void stop();
+
+    // Bots join or leave on the swarm thread; safe to call from any thread
+    inline void setBotCount(int count) { target_ = count; }
+
+    inline int getWelcomedCount() const { return welcomed_; }
+
+    inline uint64_t getStatesReceived() const { return statesReceived_; }
+
+    inline uint64_t getCastsSent() const { return castsSent_; }
+
+private:
+    struct Bot {
+        UdpSocket socket;
+        BenchRandom rng{0};
+        bool welcomed = false;
+        EntityId entity = 0;
+        uint32_t sequence = 0;
+        float heading = 0.0f;
+        float turnRate = 0.0f;
+        uint32_t nextTurnTick = 0;
+        uint32_t nextCastTick = 0;
+        float x = 0.0f;
+        float y = 0.0f;
+        // Tick of the newest state received, sent back so the server can rewind our casts
+        uint32_t viewTick = 0;
+        bool hasTarget = false;
+        float targetX = 0.0f;
+        float targetY = 0.0f;
+    };
+
+    void run();
+    void resize();
+    void receive(Bot &bot);
+    void sendInput(Bot &bot);
+
+    NetAddress server_;
+    BotConfig config_;
+    std::vector<std::unique_ptr<Bot>> bots_;
+    uint32_t tick_ = 0;
+    uint64_t spawned_ = 0;
+
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+    std::atomic<int> target_{0};
+    std::atomic<int> welcomed_{0};
+    std::atomic<uint64_t> statesReceived_{0};
+    std::atomic<uint64_t> castsSent_{0};
+
+    std::vector<uint8_t> buffer_;
+    std::vector<uint8_t> message_;
+    std::vector<SpellEvent> events_;
+    std::vector<EntitySnapshot> entities_;
+};
+
+#endif //MAGEVOICE_BOTSWARM_H
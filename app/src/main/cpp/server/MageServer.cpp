@@ -0,0 +1,240 @@
+// Headless authoritative game server with a bot load generator.
+//
+//   MageServer [--quick] [--port P] [--tick-rate R] [--rewind-ms M] [--ramp 16,32,64] [--step-seconds S]
+//              [--casts-per-second C]
+//   MageServer --serve [--port P] [--tick-rate R] [--rewind-ms M] [--step-seconds S]
+//   MageServer --connect A.B.C.D:PORT --bots N [--seconds S] [--tick-rate R] [--casts-per-second C]
+//
+// The default mode runs the server and local bots over loopback UDP, raising the bot count at
+// every step and reporting what the server sustained: achieved tick rate, tick time percentiles,
+// CPU of the server thread and bandwidth. --serve runs only the server (for bots or phones on
+// other hosts), --connect runs only bots against a remote server. --rewind-ms caps how far back
+// casts are hit tested (0 turns lag compensation off). Before the ramp, the default mode checks
+// that empty datagrams queued ahead of a join do not stop the server reading it.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <ctime>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "BenchUtil.h"
+#include "BotSwarm.h"
+#include "GameServer.h"
+#include "NetMessage.h"
+#include "Physics.h"
+#include "UdpSocket.h"
+
+constexpr uint16_t kDefaultPort = 27960;
+
+static std::atomic<bool> g_interrupted{false};
+
+static void onInterrupt(int) { g_interrupted = true; }
+
+// CPU time of the calling thread, so bots in the same process are not counted
+static double threadCpuSeconds() {
+    timespec t{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &t);
+    return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+static std::vector<int> parseList(const char *text) {
+    std::vector<int> values;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) values.push_back(std::atoi(item.c_str()));
+    }
+    return values;
+}
+
+struct StepReport {
+    int clients = 0;
+    double ticksPerSecond = 0.0;
+    double p50 = 0.0, p95 = 0.0, p99 = 0.0, max = 0.0;
+    double cpuPercent = 0.0;
+    double kbInPerSecond = 0.0;
+    double kbOutPerSecond = 0.0;
+    double bytesPerClientTick = 0.0;
+};
+
+// Runs fixed rate ticks for the given wall time (or until interrupted) and measures them
+static StepReport runStep(GameServer &server, double seconds) {
+    const int tickRate = server.getConfig().tickRate;
+    const auto period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(1.0 / tickRate));
+    const ServerTraffic before = server.getTraffic();
+    const double cpuStart = threadCpuSeconds();
+    std::vector<double> tickMs;
+    uint64_t clientTicks = 0;
+
+    Stopwatch wall;
+    auto next = std::chrono::steady_clock::now();
+    while (wall.elapsedMs() < seconds * 1000.0 && !g_interrupted) {
+        Stopwatch tick;
+        server.receive();
+        server.tick();
+        tickMs.push_back(tick.elapsedMs());
+        clientTicks += server.getClientCount();
+
+        next += period;
+        auto now = std::chrono::steady_clock::now();
+        // An overloaded server drops ticks rather than running a burst of them
+        if (now > next + period) next = now;
+        std::this_thread::sleep_until(next);
+    }
+
+    const double elapsed = wall.elapsedMs() / 1000.0;
+    const ServerTraffic &after = server.getTraffic();
+    StepReport report;
+    report.clients = server.getClientCount();
+    report.ticksPerSecond = tickMs.size() / elapsed;
+    std::sort(tickMs.begin(), tickMs.end());
+    report.p50 = percentile(tickMs, 50);
+    report.p95 = percentile(tickMs, 95);
+    report.p99 = percentile(tickMs, 99);
+    report.max = tickMs.empty() ? 0.0 : tickMs.back();
+    report.cpuPercent = 100.0 * (threadCpuSeconds() - cpuStart) / elapsed;
+    report.kbInPerSecond = (after.bytesIn - before.bytesIn) / 1024.0 / elapsed;
+    report.kbOutPerSecond = (after.bytesOut - before.bytesOut) / 1024.0 / elapsed;
+    report.bytesPerClientTick = clientTicks ? double(after.bytesOut - before.bytesOut) / clientTicks : 0.0;
+    return report;
+}
+
+static void printHeader() {
+    std::printf("%6s %8s %8s %8s %8s %8s %8s %7s %9s %9s %9s\n", "bots", "clients", "ticks/s", "p50 ms",
+                "p95 ms", "p99 ms", "max ms", "cpu %", "in KB/s", "out KB/s", "B/cl/tick");
+}
+
+static void printReport(int bots, const StepReport &r) {
+    std::printf("%6d %8d %8.1f %8.3f %8.3f %8.3f %8.3f %7.1f %9.1f %9.1f %9.1f\n", bots, r.clients, r.ticksPerSecond,
+                r.p50, r.p95, r.p99, r.max, r.cpuPercent, r.kbInPerSecond, r.kbOutPerSecond, r.bytesPerClientTick);
+    std::fflush(stdout);
+}
+
+static int runBotsOnly(int argc, char **argv, const BotConfig &botConfig) {
+    NetAddress server;
+    if (!NetAddress::parse(optionValue(argc, argv, "--connect", ""), server)) {
+        std::fprintf(stderr, "--connect expects A.B.C.D:PORT\n");
+        return 1;
+    }
+    const int bots = optionInt(argc, argv, "--bots", 32);
+    const int seconds = optionInt(argc, argv, "--seconds", 60);
+
+    BotSwarm swarm(server, botConfig);
+    swarm.setBotCount(bots);
+    swarm.start();
+    Stopwatch wall;
+    while (wall.elapsedMs() < seconds * 1000.0 && !g_interrupted) {
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+        std::printf("%d/%d bots welcomed, %llu states received, %llu casts sent\n", swarm.getWelcomedCount(), bots,
+                    (unsigned long long) swarm.getStatesReceived(), (unsigned long long) swarm.getCastsSent());
+        std::fflush(stdout);
+    }
+    swarm.stop();
+    return 0;
+}
+
+// Empty datagrams ahead of a join must not stop the server draining its queue before the join
+static bool checkEmptyDatagrams(const ServerConfig &config) {
+    GameServer server(config);
+    UdpSocket client;
+    NetAddress to;
+    if (!server.open(0) || !client.open(0)) return false;
+    NetAddress::parse("127.0.0.1:" + std::to_string(server.getPort()), to);
+    std::vector<uint8_t> join;
+    NetMessage::writeJoin(join);
+    for (int i = 0; i < 3; i++) client.sendTo(to, join.data(), 0);
+    client.sendTo(to, join.data(), join.size());
+    // Loopback delivers at once; the wait only makes sure all four are queued for one drain
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    server.receive();
+    return server.getClientCount() == 1;
+}
+
+int main(int argc, char **argv) {
+    const bool quick = hasFlag(argc, argv, "--quick");
+    const int port = optionInt(argc, argv, "--port", quick ? 0 : kDefaultPort);
+    const double stepSeconds = optionInt(argc, argv, "--step-seconds", quick ? 1 : 10);
+    std::signal(SIGINT, onInterrupt);
+
+    ServerConfig config;
+    config.tickRate = optionInt(argc, argv, "--tick-rate", kTickRate);
+    config.maxRewindSeconds = optionInt(argc, argv, "--rewind-ms", int(config.maxRewindSeconds * 1000.0f)) / 1000.0f;
+    BotConfig botConfig;
+    botConfig.tickRate = config.tickRate;
+    const char *castRate = optionValue(argc, argv, "--casts-per-second");
+    if (castRate) botConfig.castsPerSecond = float(std::atof(castRate));
+
+    if (optionValue(argc, argv, "--connect")) return runBotsOnly(argc, argv, botConfig);
+
+    GameServer server(config);
+    if (!server.open(uint16_t(port))) {
+        std::fprintf(stderr, "cannot bind UDP port %d\n", port);
+        return 1;
+    }
+    std::printf("server on UDP port %d, %d Hz\n", server.getPort(), config.tickRate);
+
+    if (hasFlag(argc, argv, "--serve")) {
+        printHeader();
+        while (!g_interrupted) printReport(0, runStep(server, stepSeconds));
+        return 0;
+    }
+
+    if (!checkEmptyDatagrams(config)) {
+        std::fprintf(stderr, "empty datagrams stopped the server from reading a join\n");
+        return 1;
+    }
+
+    std::vector<int> ramp = parseList(optionValue(argc, argv, "--ramp", quick ? "4,16" : "16,32,64,128,256,512"));
+    NetAddress local;
+    NetAddress::parse("127.0.0.1:" + std::to_string(server.getPort()), local);
+    BotSwarm swarm(local, botConfig);
+    swarm.start();
+
+    printHeader();
+    int sustained = 0;
+    bool joined = true;
+    for (int bots : ramp) {
+        swarm.setBotCount(bots);
+        // Let the bots join before measuring
+        Stopwatch joining;
+        while (server.getClientCount() != bots && joining.elapsedMs() < 2000.0 && !g_interrupted) {
+            runStep(server, 0.1);
+        }
+        StepReport report = runStep(server, stepSeconds);
+        printReport(bots, report);
+        joined = joined && report.clients == bots;
+        if (report.ticksPerSecond >= 0.98 * config.tickRate && report.p99 < 1000.0 / config.tickRate) {
+            sustained = bots;
+        }
+        if (g_interrupted) break;
+    }
+    const uint64_t states = swarm.getStatesReceived();
+    swarm.stop();
+
+    std::printf("sustained %d bots at %d Hz (>= 98%% of the tick rate and p99 within the tick budget)\n",
+                sustained, config.tickRate);
+    std::printf("bots received %llu states, sent %llu casts\n", (unsigned long long) states,
+                (unsigned long long) swarm.getCastsSent());
+    if (!joined || states == 0) {
+        std::fprintf(stderr, "bots did not all join or receive state\n");
+        return 1;
+    }
+
+    // Movement, separation and knockback all slide along the arena's rocks
+    const World &world = server.getWorld();
+    const ObstacleGrid &obstacles = server.getTilemap().getObstacles();
+    for (int e = 0; e < world.size(); e++) {
+        if (world.alive[e] && obstacles.overlaps(world.posX[e], world.posY[e], Physics::kPlayerRadius)) {
+            std::fprintf(stderr, "player %d ended inside a rock at (%.2f, %.2f)\n", e, world.posX[e], world.posY[e]);
+            return 1;
+        }
+    }
+    return 0;
+}
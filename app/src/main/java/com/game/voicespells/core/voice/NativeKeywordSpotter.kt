@@ -0,0 +1,138 @@
+package com.game.voicespells.core.voice
+
+import android.annotation.SuppressLint
+import android.content.Context
+import android.media.AudioFormat
+import android.media.AudioRecord
+import android.media.MediaRecorder
+import android.os.Handler
+import android.os.Looper
+import android.util.Log
+import com.game.voicespells.game.spells.SpellType
+import kotlin.concurrent.thread
+
+/**
+ * Streams microphone audio into the native keyword spotter, which matches 10 ms feature frames
+ * against recordings of the spell words and reports a spell as soon as it is confident,
+ * without waiting for the utterance to end.
+ *
+ * Templates are read from assets/keywords/<command>.wav (16-bit PCM mono, 16 kHz, one recording
+ * of each spell word). They are not part of the repository: they have to be recorded for the
+ * target voice/language and dropped into app/src/main/assets/keywords/ before building. When
+ * none are available a warning is logged, [isAvailable] is false and callers should fall back to
+ * the platform recognizer (and call [destroy]).
+ *
+ * @param context Used to open the keyword assets.
+ * @param onSpellDetected Called on the main thread with the detected spell; detection runs on
+ * the audio thread and is posted from there.
+ */
+class NativeKeywordSpotter(
+    context: Context,
+    private val onSpellDetected: (SpellType) -> Unit
+) {
+    private val spellTypes = SpellType.values().filter { it != SpellType.UNKNOWN }
+    private var handle: Long = nativeCreate()
+    private var audioRecord: AudioRecord? = null
+    @Volatile private var running = false
+    private var worker: Thread? = null
+    private val mainHandler = Handler(Looper.getMainLooper())
+
+    val isAvailable: Boolean
+
+    init {
+        val missing = mutableListOf<String>()
+        spellTypes.forEach { type ->
+            val loaded = try {
+                val bytes = context.assets.open("keywords/${type.command}.wav").use { it.readBytes() }
+                nativeAddTemplateWav(handle, type.ordinal, bytes)
+            } catch (e: java.io.IOException) {
+                false
+            }
+            if (!loaded) missing.add(type.command)
+        }
+        isAvailable = missing.size < spellTypes.size
+        if (!isAvailable) {
+            Log.w(TAG, "No keyword templates in assets/keywords/, native spotting disabled; using the platform recognizer")
+        } else if (missing.isNotEmpty()) {
+            Log.w(TAG, "No usable keyword template for: ${missing.joinToString()}")
+        }
+    }
+
+    /**
+     * Starts capturing and spotting on a worker thread.
+     * @return true if the spotter is listening, false if it is unavailable or the microphone
+     * could not be opened (the failure is logged).
+     */
+    @SuppressLint("MissingPermission") // RECORD_AUDIO is requested by GameActivity before use
+    fun start(): Boolean {
+        if (!isAvailable) return false
+        if (running) return true
+        val minBuffer = AudioRecord.getMinBufferSize(SAMPLE_RATE, AudioFormat.CHANNEL_IN_MONO, AudioFormat.ENCODING_PCM_16BIT)
+        val record = AudioRecord(
+            MediaRecorder.AudioSource.VOICE_RECOGNITION,
+            SAMPLE_RATE,
+            AudioFormat.CHANNEL_IN_MONO,
+            AudioFormat.ENCODING_PCM_16BIT,
+            maxOf(minBuffer, HOP_SAMPLES * 2 * 8)
+        )
+        if (record.state != AudioRecord.STATE_INITIALIZED) {
+            Log.e(TAG, "AudioRecord failed to initialize (microphone busy or permission denied)")
+            record.release()
+            return false
+        }
+        nativeReset(handle)
+        audioRecord = record
+        running = true
+        record.startRecording()
+        worker = thread(name = "KeywordSpotter") {
+            val buffer = ShortArray(HOP_SAMPLES)
+            while (running) {
+                val read = record.read(buffer, 0, buffer.size)
+                if (read <= 0) continue
+                val keyword = nativeProcess(handle, buffer, read)
+                if (keyword >= 0) {
+                    val type = SpellType.values()[keyword]
+                    mainHandler.post { onSpellDetected(type) }
+                }
+            }
+        }
+        return true
+    }
+
+    fun stop() {
+        running = false
+        worker?.join()
+        worker = null
+        audioRecord?.run {
+            stop()
+            release()
+        }
+        audioRecord = null
+    }
+
+    fun destroy() {
+        stop()
+        // Detections still queued for the main thread must not reach a destroyed owner
+        mainHandler.removeCallbacksAndMessages(null)
+        if (handle != 0L) {
+            nativeDestroy(handle)
+            handle = 0L
+        }
+    }
+
+    private external fun nativeCreate(): Long
+    private external fun nativeDestroy(handle: Long)
+    private external fun nativeAddTemplateWav(handle: Long, keyword: Int, wavBytes: ByteArray): Boolean
+    private external fun nativeProcess(handle: Long, pcm: ShortArray, count: Int): Int
+    private external fun nativeReset(handle: Long)
+
+    companion object {
+        private const val TAG = "NativeKeywordSpotter"
+        private const val SAMPLE_RATE = 16000
+        private const val HOP_SAMPLES = 160 // 10 ms, one feature frame
+
+        init {
+            System.loadLibrary("magevoice")
+        }
+    }
+}
@@ -12,6 +12,7 @@ import com.game.voicespells.domain.entities.Gust
 import com.game.voicespells.domain.entities.Lightning
 import com.game.voicespells.domain.entities.Spell
 import com.game.voicespells.domain.entities.Stone
+import com.game.voicespells.game.spells.SpellType
 import kotlinx.coroutines.flow.MutableStateFlow
 import kotlinx.coroutines.flow.StateFlow
 
@@ -24,6 +25,8 @@ import kotlinx.coroutines.flow.StateFlow
 class VoiceRecognitionManager(private val context: Context) {
 
     private var speechRecognizer: SpeechRecognizer? = null
+    // On-device streaming spotter; preferred over SpeechRecognizer when keyword templates ship with the app
+    private var keywordSpotter: NativeKeywordSpotter? = null
     private val recognizerIntent: Intent = Intent(RecognizerIntent.ACTION_RECOGNIZE_SPEECH).apply {
         putExtra(RecognizerIntent.EXTRA_LANGUAGE_MODEL, RecognizerIntent.LANGUAGE_MODEL_FREE_FORM)
         putExtra(RecognizerIntent.EXTRA_PARTIAL_RESULTS, true)
@@ -46,6 +49,18 @@ class VoiceRecognitionManager(private val context: Context) {
      * Initializes the SpeechRecognizer instance.
      */
     fun initializeRecognizer() {
+        keywordSpotter?.destroy()
+        val spotter = NativeKeywordSpotter(context) { type ->
+            spellForType(type)?.let { executeSpell(it) }
+        }
+        if (spotter.isAvailable) {
+            keywordSpotter = spotter
+        } else {
+            // Frees the native spotter; the platform recognizer takes over
+            spotter.destroy()
+            keywordSpotter = null
+        }
+
         if (SpeechRecognizer.isRecognitionAvailable(context)) {
             speechRecognizer = SpeechRecognizer.createSpeechRecognizer(context)
             speechRecognizer?.setRecognitionListener(createRecognitionListener())
@@ -59,6 +74,12 @@ class VoiceRecognitionManager(private val context: Context) {
      * The button press action should call this.
      */
     fun startListening() {
+        val spotter = keywordSpotter
+        if (spotter != null) {
+            // Without a microphone nothing is heard; do not show an active listener
+            _status.value = if (spotter.start()) RecognitionStatus.LISTENING else RecognitionStatus.IDLE
+            return
+        }
         speechRecognizer?.startListening(recognizerIntent)
         _status.value = RecognitionStatus.LISTENING
     }
@@ -68,6 +89,13 @@ class VoiceRecognitionManager(private val context: Context) {
      * The button release action should call this.
      */
     fun stopListening() {
+        val spotter = keywordSpotter
+        if (spotter != null) {
+            // Spotter detections are already final, nothing left to process
+            spotter.stop()
+            _status.value = RecognitionStatus.IDLE
+            return
+        }
         speechRecognizer?.stopListening()
         _status.value = RecognitionStatus.PROCESSING
     }
@@ -76,6 +104,7 @@ class VoiceRecognitionManager(private val context: Context) {
      * Cleans up the SpeechRecognizer instance.
      */
     fun destroy() {
+        keywordSpotter?.destroy()
         speechRecognizer?.destroy()
     }
 
@@ -140,6 +169,15 @@ class VoiceRecognitionManager(private val context: Context) {
         }
     }
 
+    private fun spellForType(type: SpellType): Spell? = when (type) {
+        SpellType.FIREBALL -> Fireball
+        SpellType.FREEZE -> Freezing
+        SpellType.LIGHTNING -> Lightning
+        SpellType.STONE -> Stone
+        SpellType.GUST -> Gust
+        SpellType.UNKNOWN -> null
+    }
+
     /**
      * "Executes" the spell. For now, it just updates the state.
      * This now accepts a Spell object.
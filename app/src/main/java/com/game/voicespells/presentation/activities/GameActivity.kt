@@ -33,7 +33,8 @@ class GameActivity : AppCompatActivity(), SurfaceHolder.Callback {
     // JNI Functions
     private external fun initNative(surface: Surface)
     private external fun onJoystickMovedNative(x: Float, y: Float)
-    private external fun cleanupNative()
+    private external fun releaseSurfaceNative()
+    private external fun cleanupNative(finishing: Boolean)
     private external fun updatePlayerStateNative(playerId: String, x: Float, y: Float, hp: Int, mana: Int)
 
     companion object {
@@ -162,7 +163,8 @@ class GameActivity : AppCompatActivity(), SurfaceHolder.Callback {
     }
 
     override fun onDestroy() {
-        cleanupNative()
+        // Not finishing means a configuration change: native keeps its GL context and game state
+        cleanupNative(isFinishing)
         NetworkManager.disconnect()
         if (::voiceRecognitionManager.isInitialized) {
             voiceRecognitionManager.destroy()
@@ -177,5 +179,7 @@ class GameActivity : AppCompatActivity(), SurfaceHolder.Callback {
 
     override fun surfaceChanged(holder: SurfaceHolder, format: Int, width: Int, height: Int) {}
 
-    override fun surfaceDestroyed(holder: SurfaceHolder) {}
+    override fun surfaceDestroyed(holder: SurfaceHolder) {
+        releaseSurfaceNative()
+    }
 }
\ No newline at end of file